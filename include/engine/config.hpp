@@ -3,13 +3,18 @@
 #define PLANKTON_ENGINE_CONFIG_HPP
 
 #include <memory>
+#include <atomic>
 #include "programs/ast.hpp"
 #include "logics/ast.hpp"
 
 namespace plankton {
 
     struct SolverConfig {
-        explicit SolverConfig() = default;
+        const std::size_t id; // unique among all configs ever created, unlike addresses; 0 is never used
+        
+        explicit SolverConfig() : id(MakeId()) {}
+        SolverConfig(const SolverConfig& /*other*/) : id(MakeId()) {}
+        SolverConfig& operator=(const SolverConfig& other) = delete;
         virtual ~SolverConfig() = default;
         
         /**
@@ -80,6 +85,11 @@ namespace plankton {
         [[nodiscard]] virtual std::unique_ptr<ImplicationSet>
         GetLogicallyContains(const MemoryAxiom& memory, const SymbolDeclaration& value) const = 0;
 
+    private:
+        static std::size_t MakeId() {
+            static std::atomic<std::size_t> counter = 1;
+            return counter++;
+        }
     };
     
 } // namespace plankton
@@ -53,11 +53,19 @@ namespace plankton {
             std::unique_ptr<InternalExpr> repr;
     };
     
+    enum struct CheckMode {
+        STRICT, // fail if the solver cannot decide a check
+        OPTIONAL // checks the solver cannot decide, e.g., due to a time or resource limit, are not implied
+    };
+
     struct Encoding { // TODO: rename to 'StackEncoding' ?
         explicit Encoding();
         explicit Encoding(const Formula& premise);
         explicit Encoding(const Formula& premise, const SolverConfig& config);
         explicit Encoding(const FlowGraph& graph);
+        Encoding(Encoding&& other) = default;
+        Encoding(const Encoding& other) = delete;
+        ~Encoding();
         
         void AddPremise(const EExpr& expr);
         void AddPremise(const Formula& premise);
@@ -68,10 +76,10 @@ namespace plankton {
         void Pop();
         
         void AddCheck(const EExpr& expr, std::function<void(bool)> callback);
-        void Check();
+        void Check(CheckMode mode = CheckMode::STRICT);
         
-        bool ImpliesFalse();
-        bool Implies(const EExpr& expr);
+        bool ImpliesFalse(CheckMode mode = CheckMode::STRICT);
+        bool Implies(const EExpr& expr, CheckMode mode = CheckMode::STRICT);
         bool Implies(const Formula& formula);
         bool Implies(const NonSeparatingImplication& formula);
         bool Implies(const ImplicationSet& formula);
@@ -129,11 +137,21 @@ namespace plankton {
             std::map<const VariableDeclaration*, EExpr> variableEncoding;
             std::map<const SymbolDeclaration*, EExpr> symbolEncoding;
             
+            explicit Encoding(const Formula& premise, const SolverConfig* config);
             EExpr MakeQuantifiedVariable(Sort sort);
             EExpr EncodeFlowRules(const FlowGraphNode& node);
             EExpr EncodeOutflow(const FlowGraphNode& node, const PointerField& field, EMode mode);
             EExpr Replace(const EExpr& expression, const EExpr& replace, const EExpr& with);
     };
+
+    /** Encodings are solved by the selected SMT backend, 'z3' by default. Changing the backend affects
+     *  encodings created afterwards only.
+     */
+    void SelectSmtBackend(const std::string& name);
+    std::vector<std::pair<std::string, std::string>> GetSmtBackends(); // name and description of all backends
+    void SelectSmtBatchMethod(const std::string& name); // 'consequences' (default), 'assumptions', or 'push-pop'
+    void SetSmtPortfolioBudget(std::size_t milliseconds); // single queries running longer are raced by a portfolio, 0 disables
+    void SetSmtQueryLimits(std::size_t milliseconds, std::size_t resourceLimit); // per query, 0 for unlimited
     
 } // plankton
 
@@ -4,11 +4,13 @@
 
 #include <deque>
 #include <memory>
+#include <unordered_map>
 #include "programs/ast.hpp"
 #include "logics/ast.hpp"
 #include "engine/config.hpp"
 #include "engine/solver.hpp"
 #include "engine/setup.hpp"
+#include "engine/util.hpp"
 #include "util/log.hpp"
 #include "util/timer.hpp"
 
@@ -39,31 +41,62 @@ namespace plankton {
         void Visit(const Program& object) override;
 
     private:
+        explicit ProofGenerator(const ProofGenerator& parent); // worker for concurrent proof generation, see 'proofJobs'
+
         using AnnotationList = std::deque<std::unique_ptr<Annotation>>;
-        using PrePostPair = std::pair<std::unique_ptr<Annotation>, AnnotationList>;
+        using Footprint = EffectFootprint;
+        struct MacroPost {
+            std::unique_ptr<Annotation> pre; // normalized
+            AnnotationList post;
+            Footprint footprint; // fields of all shared memory whose stability the derivation of 'post' relied on
+            AnnotationSignature signature; // of 'pre'
+            std::size_t key; // hash of 'pre'
+
+            explicit MacroPost(std::unique_ptr<Annotation> pre, AnnotationList post, Footprint footprint);
+        };
+        struct MacroTabulation {
+            std::deque<MacroPost> entries;
+            std::unordered_multimap<std::size_t, std::size_t> exact; // 'key' ~> position in 'entries'
+
+            void Add(MacroPost entry);
+            [[nodiscard]] bool Contains(const MacroPost& entry) const; // entry with syntactically equal 'pre'
+            void RemoveIf(const std::function<bool(const MacroPost&)>& unaryPredicate);
+        };
 
         const Program& program;
+        const SolverConfig& config;
         Solver solver;
         EngineSetup setup;
         std::deque<std::unique_ptr<HeapEffect>> newInterference;
         std::deque<std::unique_ptr<Annotation>> current;
         std::deque<std::unique_ptr<Annotation>> breaking;
         std::deque<std::pair<std::unique_ptr<Annotation>, const Return*>> returning;
-        std::map<const Function*, std::deque<PrePostPair>> macroPostTable;
+        std::map<const Function*, MacroTabulation> macroPostTable; // persists across iterations
+        std::deque<Footprint> macroFootprints; // footprints of the macro posts currently being derived
         bool insideAtomic;
-        std::deque<std::unique_ptr<FutureSuggestion>> futureSuggestions;
+        std::shared_ptr<const std::deque<std::unique_ptr<FutureSuggestion>>> futureSuggestions;
 
         #define INFO_SIZE (" (" + std::to_string(current.size()) + ") ")
         StatusStack infoPrefix;
         Timer timePost, timeJoin, timeInterference, timePastImprove, timePastReduce, timeFutureImprove, timeFutureReduce;
     
+        [[nodiscard]] std::string MakeProofCacheKey() const;
+        [[nodiscard]] std::string MakeMacroCacheKey(const Function& function) const;
+        void LoadProofCache();
+        void StoreProofCache() const;
+        void LoadInterferenceSeed();
+        void StoreInterference() const;
+
         void HandleInterfaceFunction(const Function& function);
+        void HandleInterfaceFunctionsConcurrently();
         void HandleMacroLazy(const Macro& macro);
         void HandleMacroEager(const Macro& macro);
         void HandleMacroProlog(const Macro& macro);
         void HandleMacroEpilog(const Macro& macro);
         std::optional<AnnotationList> LookupMacroPost(const Macro& node, const Annotation& pre);
-        void AddMacroPost(const Macro& node, const Annotation& pre, const AnnotationList& post);
+        void AddMacroPost(const Macro& node, const Annotation& pre, const AnnotationList& post, const Footprint& footprint);
+        void AddToMacroFootprints(const Footprint& footprint);
+        EffectFootprint* MacroFootprint(); // innermost footprint being recorded, if any
 
         void MakeInterferenceStable(const Statement& after);
         void AddNewInterference(std::deque<std::unique_ptr<HeapEffect>> effects);
@@ -2,6 +2,7 @@
 #ifndef PLANKTON_ENGINE_SETUP_HPP
 #define PLANKTON_ENGINE_SETUP_HPP
 
+#include <string>
 
 namespace plankton {
 
@@ -19,6 +20,17 @@ namespace plankton {
 
         // proof
         std::size_t proofMaxIterations = 7;
+        std::size_t proofJobs = 1; // number of API functions handled concurrently
+        std::string proofCachePath; // file persisting the proof across runs, disabled if empty
+        std::string interferenceSeedPath; // file with effects the interference set is initialized with, disabled if empty
+        std::string interferenceOutputPath; // file the final interference set is written to, disabled if empty
+
+        // solving
+        std::string smtBackend = "z3"; // see 'plankton::GetSmtBackends'
+        std::string smtBatchMethod = "consequences"; // how batches of checks are solved, see 'plankton::SelectSmtBatchMethod'
+        std::size_t smtPortfolioBudget = 0; // milliseconds before racing a query with a portfolio of configurations, disabled if 0
+        std::size_t smtTimeout = 0; // milliseconds per query, unlimited if 0
+        std::size_t smtResourceLimit = 0; // Z3 resource limit (rlimit) per query, unlimited if 0
 
         explicit EngineSetup() = default;
     };
@@ -4,6 +4,8 @@
 
 #include <deque>
 #include <memory>
+#include <set>
+#include <string>
 #include "programs/ast.hpp"
 #include "logics/ast.hpp"
 #include "engine/config.hpp"
@@ -21,6 +23,8 @@ namespace plankton {
                             std::unique_ptr<Formula> context);
     };
 
+    using EffectFootprint = std::set<std::pair<const Type*, std::string>>; // node type and field that must not be updated, "" for the flow
+
     struct PostImage final {
         std::deque<std::unique_ptr<Annotation>> annotations;
         std::deque<std::unique_ptr<HeapEffect>> effects;
@@ -34,6 +38,7 @@ namespace plankton {
 
     struct Solver final {
         explicit Solver(const Program& program, const SolverConfig& config);
+        explicit Solver(const Solver& other); // deep copies interference
 
         [[nodiscard]] std::unique_ptr<Annotation> PostEnter(std::unique_ptr<Annotation> pre, const Program& scope) const;
         [[nodiscard]] std::unique_ptr<Annotation> PostEnter(std::unique_ptr<Annotation> pre, const Function& scope) const;
@@ -53,13 +58,14 @@ namespace plankton {
         [[nodiscard]] std::unique_ptr<Annotation> TryAddFulfillment(std::unique_ptr<Annotation> annotation) const;
 
         bool AddInterference(std::deque<std::unique_ptr<HeapEffect>> interference);
-        [[nodiscard]] std::unique_ptr<Annotation> MakeInterferenceStable(std::unique_ptr<Annotation> annotation) const;
+        [[nodiscard]] const std::deque<std::unique_ptr<HeapEffect>>& GetInterference() const;
+        [[nodiscard]] std::unique_ptr<Annotation> MakeInterferenceStable(std::unique_ptr<Annotation> annotation, EffectFootprint* footprint = nullptr) const;
 
         [[nodiscard]] bool IsUnsatisfiable(const Annotation& annotation) const;
         [[nodiscard]] bool Implies(const Annotation& premise, const Annotation& conclusion) const;
 
-        [[nodiscard]] std::unique_ptr<Annotation> ImprovePast(std::unique_ptr<Annotation> annotation) const; // TODO: past suggestions
-        [[nodiscard]] PostImage ImproveFuture(std::unique_ptr<Annotation> annotation, const FutureSuggestion& target) const;
+        [[nodiscard]] std::unique_ptr<Annotation> ImprovePast(std::unique_ptr<Annotation> annotation, EffectFootprint* footprint = nullptr) const; // TODO: past suggestions
+        [[nodiscard]] PostImage ImproveFuture(std::unique_ptr<Annotation> annotation, const FutureSuggestion& target, EffectFootprint* footprint = nullptr) const;
         [[nodiscard]] std::unique_ptr<Annotation> ReducePast(std::unique_ptr<Annotation> annotation) const;
         [[nodiscard]] std::unique_ptr<Annotation> ReduceFuture(std::unique_ptr<Annotation> annotation) const;
 
@@ -75,6 +81,15 @@ namespace plankton {
     
     
     std::ostream& operator<<(std::ostream& out, const HeapEffect& object);
+    
+    struct ImplicationCacheStatistics final {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t size = 0;
+    };
+    
+    ImplicationCacheStatistics GetImplicationCacheStatistics(); // shared by all 'Solver' instances
+    void ClearImplicationCache();
 
 } // namespace plankton
 
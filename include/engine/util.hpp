@@ -4,7 +4,9 @@
 
 #include "programs/ast.hpp"
 #include "logics/ast.hpp"
+#include "logics/serialize.hpp"
 #include "engine/solver.hpp"
+#include "engine/static.hpp"
 #include "engine/encoding.hpp"
 
 namespace plankton {
@@ -29,9 +31,18 @@ namespace plankton {
 
     bool UpdatesFlow(const HeapEffect& effect);
     bool UpdatesField(const HeapEffect& effect, const std::string& field);
+    void AddToFootprint(const HeapEffect& effect, EffectFootprint& footprint); // fields updated by 'effect'
+    void AddToFootprint(const Annotation& annotation, EffectFootprint& footprint); // all fields of all shared memory in 'annotation'
+    bool IsAffected(const EffectFootprint& footprint, const HeapEffect& effect); // 'effect' updates a field in 'footprint'
     
     void AvoidEffectSymbols(SymbolFactory& factory, const HeapEffect& effect);
     void AvoidEffectSymbols(SymbolFactory& factory, const std::deque<std::unique_ptr<HeapEffect>>& effects);
+    void RemoveDuplicateEffects(std::deque<std::unique_ptr<HeapEffect>>& effects); // keeps first occurrence, drops null
+
+    void Serialize(LogicWriter& writer, const HeapEffect& effect);
+    void Serialize(LogicWriter& writer, const FutureSuggestion& suggestion);
+    std::unique_ptr<HeapEffect> DeserializeHeapEffect(LogicReader& reader);
+    std::unique_ptr<FutureSuggestion> DeserializeFutureSuggestion(LogicReader& reader);
     
     void MakeMemoryAccessible(SeparatingConjunction& formula, std::set<const SymbolDeclaration*> addresses,
                               const Type& flowType, SymbolFactory& factory, Encoding& encoding);
@@ -44,6 +55,15 @@ namespace plankton {
     void ExtendStack(Annotation& annotation, Encoding& encoding, ExtensionPolicy policy);
     void ExtendStack(Annotation& annotation, const SolverConfig& config, ExtensionPolicy policy);
     
+    struct AnnotationSignature {
+        std::set<const VariableDeclaration*> variables;
+        std::map<Specification, std::size_t> obligations;
+        std::set<bool> fulfillments;
+        
+        explicit AnnotationSignature(const Annotation& annotation);
+        [[nodiscard]] bool MayImply(const AnnotationSignature& conclusion) const; // necessary for Solver::Implies
+    };
+    
     struct ReachSet {
         std::map<const SymbolDeclaration*, std::set<const SymbolDeclaration*>> container;
         [[nodiscard]] bool IsReachable(const SymbolDeclaration& source, const SymbolDeclaration& target) const;
@@ -3,7 +3,9 @@
 #define PLANKTON_LOGICS_AST_HPP
 
 #include <set>
+#include <map>
 #include <deque>
+#include <vector>
 #include <memory>
 #include <functional>
 #include "visitors.hpp"
@@ -39,9 +41,11 @@ namespace plankton {
         
         [[nodiscard]] bool operator==(const SymbolDeclaration& other) const;
         [[nodiscard]] bool operator!=(const SymbolDeclaration& other) const;
+        [[nodiscard]] std::size_t GetPoolIndex() const;
         
         private:
-            explicit SymbolDeclaration(std::string name, const Type& type, Order order);
+            std::size_t poolIndex; // position among all symbols of the same type and order
+            explicit SymbolDeclaration(std::string name, const Type& type, Order order, std::size_t poolIndex);
             friend struct SymbolFactory;
     };
     
@@ -57,7 +61,13 @@ namespace plankton {
         inline const SymbolDeclaration& GetFreshSO(const Type& type) { return GetFresh(type, Order::SECOND); }
         
         private:
-            std::set<const SymbolDeclaration*> inUse;
+            struct FreeList {
+                std::vector<bool> inUse; // indexed by 'SymbolDeclaration::poolIndex'
+                std::size_t cursor = 0; // all symbols before 'cursor' are in use
+            };
+            std::map<std::pair<const Type*, Order>, FreeList> freeLists;
+            
+            void MarkInUse(const SymbolDeclaration& decl);
     };
 
     //
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef PLANKTON_LOGICS_SERIALIZE_HPP
+#define PLANKTON_LOGICS_SERIALIZE_HPP
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <tuple>
+#include "ast.hpp"
+
+namespace plankton {
+
+    /** Serialized objects refer to types and variables of the program they were written for by name.
+     *  Symbols are written by name, type, and order; a reader maps them to fresh symbols consistently
+     *  across all objects it reads, so objects written by the same writer keep sharing symbols.
+     */
+
+    enum struct SerializationFormat { TEXT, BINARY };
+
+    struct SerializationSink;
+    struct SerializationSource;
+    struct LogicObjectReader;
+
+    struct LogicWriter final {
+        explicit LogicWriter(std::ostream& stream, const Program& program, SerializationFormat format = SerializationFormat::TEXT);
+        LogicWriter(const LogicWriter& other) = delete;
+        ~LogicWriter();
+
+        void Write(const LogicObject& object);
+        void Write(const MemoryWrite& command);
+
+        private:
+            std::unique_ptr<SerializationSink> sink;
+            std::map<const VariableDeclaration*, std::pair<std::string, std::string>> variables; // decl -> (scope, id)
+    };
+
+    struct LogicReader final {
+        explicit LogicReader(std::istream& stream, const Program& program, SerializationFormat format = SerializationFormat::TEXT);
+        LogicReader(const LogicReader& other) = delete;
+        ~LogicReader();
+
+        [[nodiscard]] bool AtEnd();
+        std::unique_ptr<LogicObject> Read();
+        std::unique_ptr<MemoryWrite> ReadMemoryWrite();
+
+        template<typename T>
+        std::unique_ptr<T> Read() {
+            auto object = Read();
+            if (auto result = dynamic_cast<T*>(object.get())) {
+                object.release(); // NOLINT(bugprone-unused-return-value)
+                return std::unique_ptr<T>(result);
+            }
+            throw std::logic_error("Deserialization failed: unexpected object."); // TODO: better error handling
+        }
+
+        private:
+            std::unique_ptr<SerializationSource> source;
+            std::map<std::pair<std::string, std::string>, const VariableDeclaration*> variables; // (scope, id) -> decl
+            std::map<std::string, const Type*> types;
+            std::map<std::tuple<std::string, const Type*, Order>, const SymbolDeclaration*> symbols;
+            SymbolFactory factory;
+
+            friend struct LogicObjectReader;
+    };
+
+} // namespace plankton
+
+#endif //PLANKTON_LOGICS_SERIALIZE_HPP
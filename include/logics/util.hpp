@@ -25,6 +25,7 @@ namespace plankton {
                                 const std::function<bool(const T&)>& filter = [](auto&) { return true; });
 
     bool SyntacticalEqual(const LogicObject& object, const LogicObject& other);
+    std::size_t SyntacticalHash(const LogicObject& object); // equal objects have equal hashes
     std::unique_ptr<Annotation> Normalize(std::unique_ptr<Annotation> annotation);
 
     void Simplify(LogicObject& object);
@@ -36,6 +37,29 @@ namespace plankton {
     void RenameSymbols(LogicObject& object, const SymbolRenaming& renaming);
     void RenameSymbols(LogicObject& object, SymbolFactory& factory);
     void RenameSymbols(LogicObject& object, const LogicObject& avoidSymbolsFrom);
+
+    struct SymbolEquivalence final {
+        // union-find over symbols, tracking the immediate value (null, true, MIN, ...) a class is known to equal
+        explicit SymbolEquivalence() = default;
+        explicit SymbolEquivalence(const SeparatingConjunction& formula); // ignores nested implications
+
+        void Add(const SeparatingConjunction& formula);
+        void Add(const StackAxiom& axiom);
+        void Union(const SymbolDeclaration& symbol, const SymbolDeclaration& other); // 'symbol' is replaced by 'other'
+        [[nodiscard]] const SymbolDeclaration& Find(const SymbolDeclaration& symbol) const;
+        [[nodiscard]] bool AreEqual(const SymbolicExpression& expression, const SymbolicExpression& other) const;
+        [[nodiscard]] bool IsContradictory() const; // syntactically, sufficient for unsatisfiability
+        [[nodiscard]] SymbolRenaming MakeRenaming() const; // maps symbols to their class representative
+
+        private:
+            mutable std::map<const SymbolDeclaration*, const SymbolDeclaration*> parent;
+            std::map<const SymbolDeclaration*, std::unique_ptr<SymbolicExpression>> values; // by class representative
+            std::deque<std::pair<std::unique_ptr<SymbolicExpression>, std::unique_ptr<SymbolicExpression>>> disequalities;
+            bool contradictory = false;
+
+            void AddValue(const SymbolDeclaration& symbol, const SymbolicExpression& value);
+            [[nodiscard]] const SymbolicExpression* Resolve(const SymbolicExpression& expression) const;
+    };
     
     std::unique_ptr<SharedMemoryCore> MakeSharedMemory(const SymbolDeclaration& address, const Type& flowType, SymbolFactory& factory);
     std::unique_ptr<LocalMemoryResource> MakeLocalMemory(const SymbolDeclaration& address, const Type& flowType, SymbolFactory& factory);
@@ -0,0 +1,220 @@
+#pragma once
+#ifndef PLANKTON_UTIL_PROFILE_HPP
+#define PLANKTON_UTIL_PROFILE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace plankton {
+
+    struct ProfileStatistics {
+        std::string unit;
+        std::uint64_t count = 0;
+        std::uint64_t total = 0;
+        std::uint64_t min = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t max = 0;
+        std::map<std::size_t, std::uint64_t> histogram; // log-linear buckets, relative error below 1/8
+
+        inline void Add(std::uint64_t value) {
+            count++;
+            total += value;
+            min = std::min(min, value);
+            max = std::max(max, value);
+            histogram[Bucket(value)]++;
+        }
+
+        inline void Merge(const ProfileStatistics& other) {
+            if (unit.empty()) unit = other.unit;
+            count += other.count;
+            total += other.total;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+            for (const auto& [bucket, amount] : other.histogram) histogram[bucket] += amount;
+        }
+
+        [[nodiscard]] inline std::uint64_t Percentile(double percentile) const {
+            if (count == 0) return 0;
+            auto rank = static_cast<std::uint64_t>(percentile * static_cast<double>(count - 1));
+            std::uint64_t seen = 0;
+            for (const auto& [bucket, amount] : histogram) {
+                seen += amount;
+                if (seen <= rank) continue;
+                return std::max(min, std::min(max, Representative(bucket)));
+            }
+            return max;
+        }
+
+    private:
+        static constexpr std::size_t EXACT = 16;
+
+        static inline std::size_t Bucket(std::uint64_t value) {
+            if (value < EXACT) return value;
+            std::size_t exponent = 63;
+            while (!(value & (std::uint64_t(1) << exponent))) exponent--;
+            auto mantissa = (value >> (exponent - 3)) & 7;
+            return EXACT + (exponent - 4) * 8 + mantissa;
+        }
+
+        static inline std::uint64_t Representative(std::size_t bucket) {
+            if (bucket < EXACT) return bucket;
+            auto exponent = (bucket - EXACT) / 8 + 4;
+            auto mantissa = (bucket - EXACT) % 8;
+            auto lower = (8 + mantissa) << (exponent - 3);
+            return lower + (std::uint64_t(1) << (exponent - 4));
+        }
+    };
+
+    /** Collects statistics per phase and per scope (e.g. proof iteration and API function).
+     *  Disabled by default; recording is a no-op until 'Enable' is called.
+     *  Every thread records into its own tables, they are merged only when taking a snapshot.
+     */
+    class Profiler {
+    private:
+        using Tables = std::map<std::string, std::map<std::string, ProfileStatistics>>;
+        struct ThreadTables {
+            std::mutex mutex; // uncontended unless a snapshot is taken
+            Tables scopes;
+        };
+
+        std::atomic<bool> enabled{false};
+        std::mutex mutex;
+        std::deque<std::unique_ptr<ThreadTables>> threads; // outlive their threads
+
+        static inline std::vector<std::string>& ScopeStack() {
+            thread_local std::vector<std::string> stack; // joined scope names, the innermost scope last
+            return stack;
+        }
+
+        inline ThreadTables& GetThreadTables() {
+            thread_local ThreadTables* tables = nullptr;
+            if (!tables) {
+                std::lock_guard<std::mutex> guard(mutex);
+                threads.push_back(std::make_unique<ThreadTables>());
+                tables = threads.back().get();
+            }
+            return *tables;
+        }
+
+        static inline void Escape(std::ostream& stream, const std::string& string) {
+            stream << '"';
+            for (auto chr : string) {
+                if (chr == '"' || chr == '\\') stream << '\\';
+                stream << chr;
+            }
+            stream << '"';
+        }
+
+        static inline void Print(std::ostream& stream, const std::map<std::string, ProfileStatistics>& phases,
+                                 const std::string& indent) {
+            stream << "{";
+            bool first = true;
+            for (const auto& [phase, stats] : phases) {
+                stream << (first ? "" : ",") << std::endl << indent << "  ";
+                Escape(stream, phase);
+                stream << ": { \"unit\": ";
+                Escape(stream, stats.unit);
+                stream << ", \"count\": " << stats.count << ", \"total\": " << stats.total;
+                stream << ", \"min\": " << (stats.count == 0 ? 0 : stats.min) << ", \"max\": " << stats.max;
+                stream << ", \"p50\": " << stats.Percentile(0.5) << ", \"p99\": " << stats.Percentile(0.99) << " }";
+                first = false;
+            }
+            stream << std::endl << indent << "}";
+        }
+
+    public:
+        class Scope {
+        private:
+            bool active;
+
+        public:
+            Scope(const Scope& other) = delete;
+            explicit Scope(const std::string& name) : active(Profiler::Instance().IsEnabled()) {
+                if (!active) return;
+                auto& stack = ScopeStack();
+                stack.push_back(stack.empty() ? name : stack.back() + "/" + name);
+            }
+            ~Scope() { if (active) ScopeStack().pop_back(); }
+        };
+
+        static inline Profiler& Instance() {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        [[nodiscard]] inline bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+        inline void Enable() { enabled = true; }
+
+        [[nodiscard]] static inline std::string CurrentScope() {
+            const auto& stack = ScopeStack();
+            return stack.empty() ? std::string() : stack.back();
+        }
+
+        inline void Record(const std::string& phase, std::uint64_t value, const char* unit) {
+            if (!IsEnabled()) return;
+            static const std::string global;
+            const auto& stack = ScopeStack();
+            auto& tables = GetThreadTables();
+            std::lock_guard<std::mutex> guard(tables.mutex);
+            auto& stats = tables.scopes[stack.empty() ? global : stack.back()][phase];
+            if (stats.unit.empty()) stats.unit = unit;
+            stats.Add(value);
+        }
+
+        inline void Record(const std::string& phase, std::chrono::steady_clock::duration duration) {
+            if (!IsEnabled()) return;
+            auto micro = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+            Record(phase, static_cast<std::uint64_t>(micro), "us");
+        }
+
+        [[nodiscard]] inline Tables Snapshot() {
+            Tables result;
+            std::lock_guard<std::mutex> guard(mutex);
+            for (const auto& tables : threads) {
+                std::lock_guard<std::mutex> threadGuard(tables->mutex);
+                for (const auto& [scope, phases] : tables->scopes) {
+                    auto& target = result[scope];
+                    for (const auto& [phase, stats] : phases) target[phase].Merge(stats);
+                }
+            }
+            return result;
+        }
+
+        [[nodiscard]] static inline std::map<std::string, ProfileStatistics> Total(
+                const std::map<std::string, std::map<std::string, ProfileStatistics>>& scopes) {
+            std::map<std::string, ProfileStatistics> result;
+            for (const auto& [scope, phases] : scopes) {
+                for (const auto& [phase, stats] : phases) result[phase].Merge(stats);
+            }
+            return result;
+        }
+
+        inline void WriteJson(std::ostream& stream) {
+            auto snapshot = Snapshot();
+            auto total = Total(snapshot);
+            stream << "{" << std::endl << "  \"phases\": ";
+            Print(stream, total, "  ");
+            stream << "," << std::endl << "  \"scopes\": {";
+            bool first = true;
+            for (const auto& [scope, phases] : snapshot) {
+                stream << (first ? "" : ",") << std::endl << "    ";
+                Escape(stream, scope.empty() ? "<global>" : scope);
+                stream << ": ";
+                Print(stream, phases, "    ");
+                first = false;
+            }
+            stream << std::endl << "  }" << std::endl << "}" << std::endl;
+        }
+    };
+
+} // plankton
+
+#endif //PLANKTON_UTIL_PROFILE_HPP
@@ -2,23 +2,33 @@
 #ifndef PLANKTON_UTIL_TIMER_HPP
 #define PLANKTON_UTIL_TIMER_HPP
 
+#include <atomic>
 #include <chrono>
 #include <sstream>
 #include "log.hpp"
+#include "profile.hpp"
 
 namespace plankton {
-    
+
+    #ifdef ENABLE_TIMER
+        inline std::atomic<bool> timerInstrumentation{true};
+    #else
+        inline std::atomic<bool> timerInstrumentation{false};
+    #endif
+
     class Timer {
     private:
         std::string info;
-        std::size_t counter;
-        std::chrono::milliseconds elapsed;
+        std::atomic<std::size_t> counter;
+        std::atomic<std::chrono::nanoseconds::rep> elapsed;
+        bool report;
+        bool instrumented;
 
         [[nodiscard]] inline std::string ToString(const std::string& note, bool sortable = false) const {
             std::stringstream stream;
-            auto milli = std::to_string(elapsed.count());
+            auto milli = std::to_string(elapsed.load() / 1000000);
             if (sortable) stream << "[" << std::string(10 - milli.length(), '0') << milli << "ms] ";
-            stream << note << " '" << info << "' (" << counter << "): ";
+            stream << note << " '" << info << "' (" << counter.load() << "): ";
             stream << milli << "ms";
             stream << std::endl;
             return stream.str();
@@ -27,35 +37,43 @@ namespace plankton {
     public:
         class Measurement {
         private:
-            Timer& parent;
+            Timer* parent;
             std::chrono::time_point<std::chrono::steady_clock> start;
 
         public:
             Measurement(const Measurement& other) = delete;
-            explicit Measurement(Timer& parent) : parent(parent), start(std::chrono::steady_clock::now()) {}
+            explicit Measurement(Timer* parent) : parent(parent) {
+                if (parent) start = std::chrono::steady_clock::now();
+            }
 
             ~Measurement() {
-                auto end = std::chrono::steady_clock::now();
-                auto myElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-                parent.elapsed += myElapsed;
-                parent.counter++;
-                // DEBUG("$MEASUREMENT for " << parent.info << ": " << myElapsed.count() << "ms" << std::endl)
+                if (!parent) return;
+                auto myElapsed = std::chrono::steady_clock::now() - start;
+                Profiler::Instance().Record(parent->info, myElapsed);
+                auto nano = std::chrono::duration_cast<std::chrono::nanoseconds>(myElapsed).count();
+                parent->elapsed.fetch_add(nano, std::memory_order_relaxed);
+                parent->counter.fetch_add(1, std::memory_order_relaxed);
+                // DEBUG("$MEASUREMENT for " << parent->info << ": " << nano << "ns" << std::endl)
             }
         };
 
-        explicit Timer(std::string info) : info(std::move(info)), counter(0), elapsed(0) {}
-        ~Timer() { INFO(ToString("Total time measured for", true)) }
+        explicit Timer(std::string info, bool report = true, bool instrumented = false)
+                : info(std::move(info)), counter(0), elapsed(0), report(report), instrumented(instrumented) {}
+        ~Timer() { if (report && (!instrumented || counter > 0)) INFO(ToString("Total time measured for", true)) }
+        void Merge(const Timer& other) { elapsed += other.elapsed.load(); counter += other.counter.load(); }
         void Print() const { INFO(ToString("Time measured for")) }
-        Measurement Measure() { return Measurement(*this); }
+        Measurement Measure() { return Measurement(this); }
+        Measurement MeasureIfInstrumented() {
+            return Measurement(timerInstrumentation.load(std::memory_order_relaxed) ? this : nullptr);
+        }
+
+        static void SetInstrumentation(bool enable) { timerInstrumentation = enable; }
     };
 
 
-    #ifdef ENABLE_TIMER
-        #define MEASURE(X) static Timer timer(X); auto measurement = timer.Measure();
-    #else
-        #define MEASURE(X) {}
-    #endif
+    // costs a relaxed atomic load unless instrumentation is enabled (default in debug builds, '--stats' otherwise)
+    #define MEASURE(X) static Timer timer(X, true, true); auto measurement = timer.MeasureIfInstrumented();
 
 } // plankton
 
-#endif //PLANKTON_UTIL_TIMER_HPP
\ No newline at end of file
+#endif //PLANKTON_UTIL_TIMER_HPP
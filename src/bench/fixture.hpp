@@ -1,8 +1,15 @@
 #pragma once
-#ifndef PLANKTON_SOLVER_TEST_HPP
-#define PLANKTON_SOLVER_TEST_HPP
+#ifndef PLANKTON_BENCH_FIXTURE_HPP
+#define PLANKTON_BENCH_FIXTURE_HPP
 
+#include <set>
+#include "programs/ast.hpp"
 #include "logics/ast.hpp"
+#include "logics/util.hpp"
+#include "engine/solver.hpp"
+#include "engine/static.hpp"
+
+// default fixture of 'plankton-micro': a proof state of 'examples/Harris.pl', other programs need '--fixture'
 
 namespace plankton {
 
@@ -56,6 +63,10 @@ namespace plankton {
     }
 
     inline std::deque<std::unique_ptr<HeapEffect>> MakeTestInterference(const Type& nodeType) {
+        for (const auto* field : { "marked", "next", "val" }) {
+            if (nodeType.GetField(field)) continue;
+            throw std::logic_error("Default fixture needs field '" + std::string(field) + "' in type '" + nodeType.name + "', use '--fixture'."); // TODO: better error handling
+        }
         SymbolFactory factory;
         std::deque<std::unique_ptr<HeapEffect>> result;
         result.push_back(MakeTestEffect1(factory, nodeType));
@@ -193,7 +204,7 @@ namespace plankton {
             for (const auto* var : collector.decls) {
                 if (var->name == name) return *var;
             }
-            throw std::logic_error("---broken debug---");
+            throw std::logic_error("Default fixture needs variable '" + name + "', use '--fixture'."); // TODO: better error handling
         }
 
         explicit TestGen(const Program& program) : annotation(std::make_unique<Annotation>()) {
@@ -498,4 +509,4 @@ namespace plankton {
     }
 }
 
-#endif //PLANKTON_SOLVER_TEST_HPP
+#endif //PLANKTON_BENCH_FIXTURE_HPP
@@ -0,0 +1,542 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "tclap/CmdLine.h"
+#include "engine/encoding.hpp"
+#include "engine/linearizability.hpp"
+#include "engine/setup.hpp"
+#include "parser/parse.hpp"
+#include "util/log.hpp"
+#include "util/timer.hpp"
+
+using namespace plankton;
+
+
+//
+// Configuration
+//
+
+static const std::vector<std::string> DEFAULT_SUITES = { "examples", "examples/buggy" };
+
+static const std::vector<std::string> REPORTED_PHASES = {
+        "TIME Post", "TIME Join", "TIME Interference", "TIME Past improve", "TIME Past reduce",
+        "TIME Future improve", "TIME Future reduce"
+};
+
+inline void AdjustSetup(const std::filesystem::path& path, EngineSetup& setup) {
+    // see benchmark.py
+    if (path.filename() == "FemrsTreeNoMaintenance.pl") setup.loopJoinPost = false;
+}
+
+
+//
+// Command Line
+//
+
+struct BenchmarkInput {
+    std::vector<std::filesystem::path> benchmarks;
+    std::size_t repetitions = 1;
+    std::size_t warmup = 0; // unmeasured runs before the measured ones
+    std::size_t timeout = 0; // seconds, 0 = none
+    std::size_t compareJobs = 0; // 0 = no comparison
+    double tolerance = 10;
+    bool profile = true;
+    bool verbose = false;
+    std::string pathToCsv;
+    std::string pathToJson;
+    std::string pathToBaseline;
+    EngineSetup setup;
+};
+
+inline void CollectBenchmarks(const std::string& path, std::vector<std::filesystem::path>& result) {
+    if (!std::filesystem::is_directory(path)) {
+        result.emplace_back(path);
+        return;
+    }
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".pl") continue;
+        files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    result.insert(result.end(), files.begin(), files.end());
+}
+
+inline BenchmarkInput Interact(int argc, char** argv) {
+    BenchmarkInput input;
+
+    TCLAP::CmdLine cmd("PLANKTON benchmark harness", ' ', "1.0");
+    TCLAP::UnlabeledMultiArg<std::string> pathsArg("paths", "Benchmark files or directories (default: examples and examples/buggy)", false, "path", cmd);
+    TCLAP::ValueArg<std::size_t> repetitionsArg("r", "repetitions", "Measured runs per benchmark", false, 1, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> warmupArg("w", "warmup", "Unmeasured runs per benchmark before the measured ones", false, 0, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> timeoutArg("t", "timeout", "Timeout per run in seconds, 0 for none", false, 0, "integer", cmd);
+    TCLAP::ValueArg<std::string> csvArg("", "csv", "Write results as CSV to the given file", false, "", "path", cmd);
+    TCLAP::ValueArg<std::string> jsonArg("", "json", "Write results as JSON to the given file", false, "", "path", cmd);
+    TCLAP::ValueArg<std::string> baselineArg("", "baseline", "Compare against a CSV file written by an earlier run", false, "", "path", cmd);
+    TCLAP::ValueArg<double> toleranceArg("", "tolerance", "Allowed slowdown against the baseline in percent", false, 10, "number", cmd);
+    TCLAP::SwitchArg noProfileSwitch("", "no-profile", "Measure wall time and memory only, without per-phase breakdown", cmd, false);
+    TCLAP::SwitchArg verboseSwitch("v", "verbose", "Do not suppress the output of the verification engine", cmd, false);
+    TCLAP::ValueArg<std::size_t> jobsArg("j", "jobs", "Number of API functions verified concurrently per fixed-point iteration", false, 1, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> compareJobsArg("", "compare-jobs", "Verify every benchmark once more with the given number of jobs and fail if verdict, iterations, or final interference size differ, 0 for never", false, 0, "integer", cmd);
+    std::vector<std::string> backends;
+    for (const auto& [name, description] : plankton::GetSmtBackends()) backends.push_back(name);
+    TCLAP::ValuesConstraint<std::string> isBackend(backends);
+    TCLAP::ValueArg<std::string> backendArg("", "smt-backend", "SMT backend used for solving", false, "z3", &isBackend, cmd);
+    std::vector<std::string> batchMethods = { "consequences", "assumptions", "push-pop" };
+    TCLAP::ValuesConstraint<std::string> isBatchMethod(batchMethods);
+    TCLAP::ValueArg<std::string> batchMethodArg("", "smt-batch", "How batches of checks are solved: solver::consequences with a per-batch fallback, assumption literals, or push/pop per check", false, "consequences", &isBatchMethod, cmd);
+    TCLAP::ValueArg<std::size_t> portfolioArg("", "smt-portfolio-ms", "Race queries taking longer than the given milliseconds with a portfolio of Z3 configurations, 0 for never", false, 0, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> timeoutMsArg("", "smt-timeout-ms", "Time limit per SMT query in milliseconds, 0 for none; optional checks exceeding it count as not implied", false, 0, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> rlimitArg("", "smt-rlimit", "Z3 resource limit per SMT query, 0 for none; optional checks exceeding it count as not implied", false, 0, "integer", cmd);
+
+    cmd.parse(argc, argv);
+    auto paths = pathsArg.getValue();
+    if (paths.empty()) paths = DEFAULT_SUITES;
+    for (const auto& path : paths) CollectBenchmarks(path, input.benchmarks);
+    input.repetitions = std::max<std::size_t>(repetitionsArg.getValue(), 1);
+    input.warmup = warmupArg.getValue();
+    input.timeout = timeoutArg.getValue();
+    input.tolerance = toleranceArg.getValue();
+    input.profile = !noProfileSwitch.getValue();
+    input.verbose = verboseSwitch.getValue();
+    input.pathToCsv = csvArg.getValue();
+    input.pathToJson = jsonArg.getValue();
+    input.pathToBaseline = baselineArg.getValue();
+    input.setup.proofJobs = std::max<std::size_t>(jobsArg.getValue(), 1);
+    input.compareJobs = compareJobsArg.getValue();
+    if (input.compareJobs > 0 && !input.profile) throw std::logic_error("Option --compare-jobs needs the profile, it cannot be combined with --no-profile."); // TODO: better error handling
+    input.setup.smtBackend = backendArg.getValue();
+    input.setup.smtBatchMethod = batchMethodArg.getValue();
+    input.setup.smtPortfolioBudget = portfolioArg.getValue();
+    input.setup.smtTimeout = timeoutMsArg.getValue();
+    input.setup.smtResourceLimit = rlimitArg.getValue();
+
+    return input;
+}
+
+
+//
+// Single run
+//
+
+enum struct Outcome { LINEARIZABLE, NOT_LINEARIZABLE, ERROR, TIMEOUT, CRASH };
+
+inline std::string OutcomeToString(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::LINEARIZABLE: return "linearizable";
+        case Outcome::NOT_LINEARIZABLE: return "not-linearizable";
+        case Outcome::ERROR: return "error";
+        case Outcome::TIMEOUT: return "timeout";
+        case Outcome::CRASH: return "crash";
+    }
+    throw std::logic_error("Unknown outcome."); // TODO: better error handling
+}
+
+struct RunResult {
+    Outcome outcome = Outcome::CRASH;
+    double wallMs = 0;
+    long peakRssKb = 0;
+    std::size_t z3Queries = 0;
+    std::size_t iterations = 0;
+    std::size_t interference = 0; // effects at the fixed point
+    std::map<std::string, double> phasesMs;
+};
+
+inline void ReportToParent(int fd, const std::string& report) {
+    for (std::size_t written = 0; written < report.size(); ) {
+        auto count = write(fd, report.data() + written, report.size() - written);
+        if (count <= 0) return;
+        written += count;
+    }
+}
+
+[[noreturn]] inline void RunChild(const std::filesystem::path& path, const BenchmarkInput& input, int fd) {
+    // runs in the forked child, results are reported line by line through 'fd'
+    if (!input.verbose) {
+        auto devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) dup2(devNull, STDOUT_FILENO);
+    }
+    if (input.profile) {
+        Timer::SetInstrumentation(true);
+        Profiler::Instance().Enable();
+    }
+
+    std::stringstream report;
+    try {
+        auto setup = input.setup;
+        AdjustSetup(path, setup);
+        auto parsed = plankton::Parse(path.string());
+        auto begin = std::chrono::steady_clock::now();
+        auto linearizable = plankton::IsLinearizable(*parsed.program, *parsed.config, setup);
+        auto end = std::chrono::steady_clock::now();
+        report << "outcome " << (linearizable ? "linearizable" : "not-linearizable") << std::endl;
+        report << "wall " << std::chrono::duration<double, std::milli>(end - begin).count() << std::endl;
+    } catch (std::logic_error&) {
+        report << "outcome error" << std::endl;
+    }
+
+    auto snapshot = Profiler::Instance().Snapshot();
+    std::set<std::string> iterations;
+    for (const auto& [scope, phases] : snapshot) {
+        if (scope.rfind("iteration ", 0) != 0) continue;
+        iterations.insert(scope.substr(0, scope.find('/')));
+    }
+    report << "iterations " << iterations.size() << std::endl;
+    for (const auto& [phase, stats] : Profiler::Total(snapshot)) {
+        if (phase == "Z3 query" || phase == "Z3 consequences") report << "queries " << stats.count << std::endl;
+        if (phase == "Interference size") report << "interference " << stats.max << std::endl;
+        if (stats.unit == "us") report << "phase " << stats.total / 1000.0 << " " << phase << std::endl;
+    }
+
+    std::cout.flush();
+    ReportToParent(fd, report.str());
+    close(fd);
+    _exit(0);
+}
+
+inline void ParseChildReport(const std::string& report, RunResult& result) {
+    std::istringstream stream(report);
+    std::string key;
+    while (stream >> key) {
+        if (key == "outcome") {
+            std::string value;
+            stream >> value;
+            if (value == "linearizable") result.outcome = Outcome::LINEARIZABLE;
+            else if (value == "not-linearizable") result.outcome = Outcome::NOT_LINEARIZABLE;
+            else result.outcome = Outcome::ERROR;
+        } else if (key == "wall") {
+            stream >> result.wallMs;
+        } else if (key == "iterations") {
+            stream >> result.iterations;
+        } else if (key == "interference") {
+            stream >> result.interference;
+        } else if (key == "queries") {
+            std::size_t count;
+            stream >> count;
+            result.z3Queries += count;
+        } else if (key == "phase") {
+            double millis;
+            std::string phase;
+            stream >> millis;
+            std::getline(stream >> std::ws, phase);
+            result.phasesMs[phase] = millis;
+        }
+    }
+}
+
+inline RunResult Run(const std::filesystem::path& path, const BenchmarkInput& input) {
+    // every run gets its own process: isolates caches and global state, allows timeouts, and yields the peak RSS
+    RunResult result;
+    int fds[2];
+    if (pipe(fds) != 0) throw std::logic_error("Could not create pipe."); // TODO: better error handling
+    std::cout.flush();
+    auto pid = fork();
+    if (pid < 0) throw std::logic_error("Could not fork."); // TODO: better error handling
+    if (pid == 0) {
+        close(fds[0]);
+        RunChild(path, input, fds[1]);
+    }
+    close(fds[1]);
+
+    auto begin = std::chrono::steady_clock::now();
+    auto deadline = begin + std::chrono::seconds(input.timeout);
+    std::string report;
+    bool timeout = false;
+    char buffer[4096];
+    while (true) {
+        int wait = -1;
+        if (input.timeout > 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                timeout = true;
+                break;
+            }
+            wait = static_cast<int>(remaining.count());
+        }
+        pollfd descriptor = { fds[0], POLLIN, 0 };
+        auto ready = poll(&descriptor, 1, wait);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) break;
+        if (ready == 0) continue;
+        auto count = read(fds[0], buffer, sizeof(buffer));
+        if (count <= 0) break;
+        report.append(buffer, count);
+    }
+    close(fds[0]);
+    if (timeout) kill(pid, SIGKILL);
+
+    int status = 0;
+    rusage usage = {};
+    wait4(pid, &status, 0, &usage);
+    result.peakRssKb = usage.ru_maxrss;
+    result.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    if (timeout) {
+        result.outcome = Outcome::TIMEOUT;
+    } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        result.outcome = Outcome::CRASH;
+    } else {
+        ParseChildReport(report, result);
+    }
+    return result;
+}
+
+
+//
+// Aggregation
+//
+
+struct BenchmarkResult {
+    std::string name;
+    Outcome expected = Outcome::LINEARIZABLE;
+    Outcome outcome = Outcome::CRASH;
+    std::size_t runs = 0;
+    double wallMedian = 0, wallMin = 0, wallMax = 0;
+    long peakRssKb = 0;
+    std::size_t z3Queries = 0;
+    std::size_t iterations = 0;
+    std::size_t interference = 0;
+    std::map<std::string, double> phasesMs; // medians
+    std::optional<double> baselineMs;
+    std::optional<std::string> jobsMismatch; // differences of the run with '--compare-jobs'
+
+    [[nodiscard]] bool IsExpected() const {
+        if (expected == Outcome::LINEARIZABLE) return outcome == Outcome::LINEARIZABLE;
+        return outcome == Outcome::NOT_LINEARIZABLE || outcome == Outcome::ERROR;
+    }
+};
+
+inline double Median(std::vector<double> values) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    auto middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+inline BenchmarkResult Aggregate(const std::filesystem::path& path, const std::vector<RunResult>& runs) {
+    assert(!runs.empty());
+    BenchmarkResult result;
+    result.name = path.string();
+    result.expected = path.parent_path().filename() == "buggy" ? Outcome::NOT_LINEARIZABLE : Outcome::LINEARIZABLE;
+    result.runs = runs.size();
+    result.outcome = runs.back().outcome;
+    for (const auto& run : runs) {
+        if (run.outcome != Outcome::LINEARIZABLE && run.outcome != Outcome::NOT_LINEARIZABLE) result.outcome = run.outcome;
+    }
+
+    std::vector<double> walls;
+    std::map<std::string, std::vector<double>> phases;
+    for (const auto& run : runs) {
+        walls.push_back(run.wallMs);
+        result.peakRssKb = std::max(result.peakRssKb, run.peakRssKb);
+        for (const auto& [phase, millis] : run.phasesMs) phases[phase].push_back(millis);
+    }
+    result.wallMedian = Median(walls);
+    result.wallMin = *std::min_element(walls.begin(), walls.end());
+    result.wallMax = *std::max_element(walls.begin(), walls.end());
+    result.z3Queries = runs.back().z3Queries;
+    result.iterations = runs.back().iterations;
+    result.interference = runs.back().interference;
+    for (auto& [phase, values] : phases) result.phasesMs[phase] = Median(std::move(values));
+    return result;
+}
+
+
+//
+// Jobs
+//
+
+inline std::optional<std::string> CompareJobs(const std::filesystem::path& path, const BenchmarkInput& input, const BenchmarkResult& result) {
+    // concurrently handled API functions must yield the proof of sequentially handled ones
+    auto other = input;
+    other.setup.proofJobs = input.compareJobs;
+    auto run = Run(path, other);
+    std::stringstream mismatch;
+    if (run.outcome != result.outcome) mismatch << " outcome " << OutcomeToString(result.outcome) << "/" << OutcomeToString(run.outcome);
+    if (run.iterations != result.iterations) mismatch << " iterations " << result.iterations << "/" << run.iterations;
+    if (run.interference != result.interference) mismatch << " interference " << result.interference << "/" << run.interference;
+    if (mismatch.str().empty()) return std::nullopt;
+    return "--jobs " + std::to_string(input.setup.proofJobs) + "/" + std::to_string(input.compareJobs) + ":" + mismatch.str();
+}
+
+
+//
+// Baseline
+//
+
+inline std::vector<std::string> SplitCsvLine(const std::string& line) {
+    std::vector<std::string> result;
+    std::stringstream stream(line);
+    std::string cell;
+    while (std::getline(stream, cell, ',')) result.push_back(cell);
+    return result;
+}
+
+inline std::map<std::string, double> ReadBaseline(const std::string& path) {
+    std::ifstream stream(path);
+    if (!stream.good()) throw std::logic_error("Could not read baseline '" + path + "'."); // TODO: better error handling
+    std::string line;
+    std::getline(stream, line);
+    auto header = SplitCsvLine(line);
+    auto nameColumn = std::find(header.begin(), header.end(), "benchmark") - header.begin();
+    auto timeColumn = std::find(header.begin(), header.end(), "wall_ms_median") - header.begin();
+    if (nameColumn == (long) header.size() || timeColumn == (long) header.size()) {
+        throw std::logic_error("Malformed baseline '" + path + "'."); // TODO: better error handling
+    }
+
+    std::map<std::string, double> result;
+    while (std::getline(stream, line)) {
+        auto cells = SplitCsvLine(line);
+        if ((long) cells.size() <= std::max(nameColumn, timeColumn)) continue;
+        result[cells.at(nameColumn)] = std::stod(cells.at(timeColumn));
+    }
+    return result;
+}
+
+inline bool IsRegression(const BenchmarkResult& result, double tolerance) {
+    if (!result.baselineMs) return false;
+    return result.wallMedian > result.baselineMs.value() * (1 + tolerance / 100);
+}
+
+
+//
+// Reporting
+//
+
+inline void WriteCsv(const std::string& path, const std::deque<BenchmarkResult>& results) {
+    std::ofstream stream(path);
+    if (!stream.good()) throw std::logic_error("Could not write '" + path + "'."); // TODO: better error handling
+    stream << "benchmark,expected,outcome,runs,wall_ms_median,wall_ms_min,wall_ms_max,peak_rss_kb,z3_queries,iterations,interference";
+    for (const auto& phase : REPORTED_PHASES) stream << "," << phase;
+    stream << std::endl;
+    for (const auto& result : results) {
+        stream << result.name << "," << OutcomeToString(result.expected) << "," << OutcomeToString(result.outcome);
+        stream << "," << result.runs << "," << result.wallMedian << "," << result.wallMin << "," << result.wallMax;
+        stream << "," << result.peakRssKb << "," << result.z3Queries << "," << result.iterations << "," << result.interference;
+        for (const auto& phase : REPORTED_PHASES) {
+            auto find = result.phasesMs.find(phase);
+            stream << "," << (find != result.phasesMs.end() ? find->second : 0);
+        }
+        stream << std::endl;
+    }
+}
+
+inline void WriteJsonString(std::ostream& stream, const std::string& string) {
+    stream << '"';
+    for (auto chr : string) {
+        if (chr == '"' || chr == '\\') stream << '\\';
+        stream << chr;
+    }
+    stream << '"';
+}
+
+inline void WriteJson(const std::string& path, const std::deque<BenchmarkResult>& results) {
+    std::ofstream stream(path);
+    if (!stream.good()) throw std::logic_error("Could not write '" + path + "'."); // TODO: better error handling
+    stream << "[";
+    bool first = true;
+    for (const auto& result : results) {
+        stream << (first ? "" : ",") << std::endl << "  { \"benchmark\": ";
+        WriteJsonString(stream, result.name);
+        stream << ", \"expected\": \"" << OutcomeToString(result.expected) << "\"";
+        stream << ", \"outcome\": \"" << OutcomeToString(result.outcome) << "\"";
+        stream << ", \"runs\": " << result.runs;
+        stream << ", \"wall_ms\": { \"median\": " << result.wallMedian << ", \"min\": " << result.wallMin << ", \"max\": " << result.wallMax << " }";
+        stream << ", \"peak_rss_kb\": " << result.peakRssKb << ", \"z3_queries\": " << result.z3Queries;
+        stream << ", \"iterations\": " << result.iterations << ", \"interference\": " << result.interference;
+        if (result.jobsMismatch) {
+            stream << ", \"jobs_mismatch\": ";
+            WriteJsonString(stream, result.jobsMismatch.value());
+        }
+        if (result.baselineMs) stream << ", \"baseline_wall_ms\": " << result.baselineMs.value();
+        stream << "," << std::endl << "    \"phases_ms\": {";
+        bool firstPhase = true;
+        for (const auto& [phase, millis] : result.phasesMs) {
+            stream << (firstPhase ? " " : ", ");
+            WriteJsonString(stream, phase);
+            stream << ": " << millis;
+            firstPhase = false;
+        }
+        stream << " } }";
+        first = false;
+    }
+    stream << std::endl << "]" << std::endl;
+}
+
+inline void PrintResult(const BenchmarkResult& result, double tolerance) {
+    std::stringstream line;
+    line << std::left << std::setw(50) << result.name << std::right;
+    line << std::setw(18) << OutcomeToString(result.outcome) << (result.IsExpected() ? " ✓" : " ✗");
+    line << std::setw(12) << std::fixed << std::setprecision(0) << result.wallMedian << "ms";
+    line << std::setw(10) << result.peakRssKb / 1024 << "MB";
+    line << std::setw(10) << result.z3Queries << " queries";
+    if (result.baselineMs) {
+        auto change = (result.wallMedian / std::max(result.baselineMs.value(), 1.0) - 1) * 100;
+        line << std::setw(8) << std::showpos << change << std::noshowpos << "%";
+        if (IsRegression(result, tolerance)) line << " REGRESSION";
+    }
+    if (result.jobsMismatch) line << " JOBS MISMATCH (" << result.jobsMismatch.value() << ")";
+    INFO(line.str() << std::endl)
+}
+
+
+//
+// Main
+//
+
+int main(int argc, char** argv) {
+    try {
+        auto input = Interact(argc, argv);
+        std::map<std::string, double> baseline;
+        if (!input.pathToBaseline.empty()) baseline = ReadBaseline(input.pathToBaseline);
+
+        INFO("Running " << input.benchmarks.size() << " benchmarks (warmup=" << input.warmup << ", repetitions="
+                        << input.repetitions << ", timeout=" << input.timeout << "s)..." << std::endl << std::endl)
+        std::deque<BenchmarkResult> results;
+        bool failed = false;
+        for (const auto& path : input.benchmarks) {
+            // runs are forked, yet the page cache and CPU clock are still cold for the first of them
+            for (std::size_t index = 0; index < input.warmup; ++index) {
+                if (Run(path, input).outcome == Outcome::TIMEOUT) break;
+            }
+            std::vector<RunResult> runs;
+            for (std::size_t index = 0; index < input.repetitions; ++index) {
+                runs.push_back(Run(path, input));
+                if (runs.back().outcome == Outcome::TIMEOUT) break;
+            }
+            auto result = Aggregate(path, runs);
+            auto find = baseline.find(result.name);
+            if (find != baseline.end()) result.baselineMs = find->second;
+            if (input.compareJobs > 0 && result.outcome != Outcome::TIMEOUT) result.jobsMismatch = CompareJobs(path, input, result);
+            failed |= !result.IsExpected() || IsRegression(result, input.tolerance) || result.jobsMismatch.has_value();
+            PrintResult(result, input.tolerance);
+            results.push_back(std::move(result));
+        }
+
+        if (!input.pathToCsv.empty()) WriteCsv(input.pathToCsv, results);
+        if (!input.pathToJson.empty()) WriteJson(input.pathToJson, results);
+        return failed ? 3 : 0;
+
+    } catch (TCLAP::ArgException& err) {
+        ERROR(err.error() << " for arg " << err.argId() << std::endl)
+        return 1;
+
+    } catch (std::logic_error& err) { // TODO: catch proper error class
+        ERROR(err.what() << std::endl)
+        return 2;
+    }
+}
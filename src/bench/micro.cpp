@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include "tclap/CmdLine.h"
+#include "engine/proof.hpp"
+#include "programs/util.hpp"
+#include "logics/util.hpp"
+#include "logics/serialize.hpp"
+#include "engine/util.hpp"
+#include "parser/parse.hpp"
+#include "util/log.hpp"
+#include "fixture.hpp"
+
+using namespace plankton;
+
+
+//
+// Harness
+//
+
+using nanoseconds_t = std::chrono::nanoseconds;
+
+struct MicroBenchmark {
+    std::string name;
+    std::function<std::function<void()>()> prepare; // untimed, returns the timed body
+};
+
+struct MicroResult {
+    std::size_t iterations = 0;
+    nanoseconds_t mean = nanoseconds_t(0), median = nanoseconds_t(0), min = nanoseconds_t(0), max = nanoseconds_t(0);
+};
+
+inline MicroResult Run(const MicroBenchmark& benchmark, std::chrono::duration<double> minTime, std::size_t minIterations) {
+    std::vector<nanoseconds_t> samples;
+    nanoseconds_t total(0);
+    while (samples.size() < minIterations || total < minTime) {
+        auto body = benchmark.prepare();
+        auto begin = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration_cast<nanoseconds_t>(end - begin));
+        total += samples.back();
+    }
+
+    MicroResult result;
+    std::sort(samples.begin(), samples.end());
+    result.iterations = samples.size();
+    result.mean = total / samples.size();
+    result.median = samples.at(samples.size() / 2);
+    result.min = samples.front();
+    result.max = samples.back();
+    return result;
+}
+
+inline std::string Format(nanoseconds_t time) {
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(1) << time.count() / 1000.0 << "us";
+    return stream.str();
+}
+
+inline void PrintHeader() {
+    INFO(std::left << std::setw(40) << "Benchmark" << std::right << std::setw(12) << "Iterations" << std::setw(16) << "Mean"
+                   << std::setw(16) << "Median" << std::setw(16) << "Min" << std::setw(16) << "Max" << std::endl)
+    INFO(std::string(116, '-') << std::endl)
+}
+
+inline void PrintResult(const std::string& name, const MicroResult& result) {
+    INFO(std::left << std::setw(40) << name << std::right << std::setw(12) << result.iterations
+                   << std::setw(16) << Format(result.mean) << std::setw(16) << Format(result.median)
+                   << std::setw(16) << Format(result.min) << std::setw(16) << Format(result.max) << std::endl)
+}
+
+
+//
+// Fixtures
+//
+
+inline void Expect(std::istream& stream, const std::string& expected) {
+    std::string token;
+    stream >> token;
+    if (token == expected) return;
+    throw std::logic_error("Malformed fixture: expected '" + expected + "'."); // TODO: better error handling
+}
+
+inline std::size_t ReadCount(std::istream& stream) {
+    std::size_t result;
+    if (stream >> result) return result;
+    throw std::logic_error("Malformed fixture: expected number."); // TODO: better error handling
+}
+
+struct Fixture {
+    ParsingResult input;
+    std::unique_ptr<Annotation> annotation;
+    std::unique_ptr<MemoryWrite> command;
+    std::deque<std::unique_ptr<HeapEffect>> interference;
+    std::unique_ptr<FutureSuggestion> future;
+    std::unique_ptr<Annotation> joined; // weaker than 'annotation', but not syntactically
+    std::unique_ptr<Solver> solver; // without interference
+    std::unique_ptr<Solver> interferingSolver; // with 'interference'
+
+    explicit Fixture(const std::string& path) : input(plankton::Parse(path)) {
+        auto& program = *input.program;
+        auto [state, write] = plankton::MakeTestState(program);
+        annotation = std::move(state);
+        command = std::move(write);
+        interference = plankton::MakeTestInterference(*program.types.at(0));
+        future = plankton::MakeDebugFuture(program);
+        Prepare();
+    }
+
+    explicit Fixture(const std::string& path, const std::string& fixturePath) : input(plankton::Parse(path)) {
+        // layout: 'fixture <#effects> <#futures>', then annotation, command, effects, and future written by a 'LogicWriter'
+        std::ifstream stream(fixturePath);
+        if (!stream.good()) throw std::logic_error("Could not read fixture '" + fixturePath + "'."); // TODO: better error handling
+        Expect(stream, "fixture");
+        auto effects = ReadCount(stream);
+        auto futures = ReadCount(stream);
+        LogicReader reader(stream, *input.program);
+        annotation = reader.Read<Annotation>();
+        command = reader.ReadMemoryWrite();
+        for (; effects > 0; --effects) interference.push_back(plankton::DeserializeHeapEffect(reader));
+        if (futures > 0) future = plankton::DeserializeFutureSuggestion(reader);
+        Prepare();
+    }
+
+    void Store(const std::string& fixturePath) const {
+        std::ofstream stream(fixturePath);
+        stream << "fixture " << interference.size() << " " << (future ? 1 : 0) << std::endl;
+        LogicWriter writer(stream, *input.program);
+        writer.Write(*annotation);
+        writer.Write(*command);
+        for (const auto& effect : interference) plankton::Serialize(writer, *effect);
+        if (future) plankton::Serialize(writer, *future);
+        if (!stream.good()) throw std::logic_error("Could not write fixture '" + fixturePath + "'."); // TODO: better error handling
+    }
+
+    void Prepare() {
+        auto& program = *input.program;
+        solver = std::make_unique<Solver>(program, *input.config);
+        interferingSolver = std::make_unique<Solver>(program, *input.config);
+        interferingSolver->AddInterference(CopyInterference());
+        std::deque<std::unique_ptr<Annotation>> join;
+        join.push_back(plankton::Copy(*annotation));
+        join.push_back(plankton::Copy(*annotation));
+        joined = solver->Join(std::move(join));
+    }
+
+    [[nodiscard]] std::deque<std::unique_ptr<HeapEffect>> CopyInterference() const {
+        std::deque<std::unique_ptr<HeapEffect>> result;
+        for (const auto& effect : interference) {
+            result.push_back(std::make_unique<HeapEffect>(plankton::Copy(*effect->pre), plankton::Copy(*effect->post),
+                                                          plankton::Copy(*effect->context)));
+        }
+        return result;
+    }
+};
+
+inline std::deque<MicroBenchmark> MakeBenchmarks(const Fixture& fixture) {
+    std::deque<MicroBenchmark> result;
+    result.push_back({ "Solver::Post (MemoryWrite)", [&fixture]() -> std::function<void()> {
+        auto pre = std::make_shared<std::unique_ptr<Annotation>>(plankton::Copy(*fixture.annotation));
+        return [&fixture, pre]() { [[maybe_unused]] auto post = fixture.solver->Post(std::move(*pre), *fixture.command, false); };
+    }});
+    result.push_back({ "Solver::Join (2 annotations)", [&fixture]() -> std::function<void()> {
+        auto input = std::make_shared<std::deque<std::unique_ptr<Annotation>>>();
+        input->push_back(plankton::Copy(*fixture.annotation));
+        input->push_back(plankton::Copy(*fixture.annotation));
+        return [&fixture, input]() { [[maybe_unused]] auto join = fixture.solver->Join(std::move(*input)); };
+    }});
+    result.push_back({ "Solver::Implies (cached)", [&fixture]() -> std::function<void()> {
+        return [&fixture]() { [[maybe_unused]] auto implied = fixture.solver->Implies(*fixture.annotation, *fixture.joined); };
+    }});
+    result.push_back({ "Solver::Implies (uncached)", [&fixture]() -> std::function<void()> {
+        plankton::ClearImplicationCache();
+        return [&fixture]() { [[maybe_unused]] auto implied = fixture.solver->Implies(*fixture.annotation, *fixture.joined); };
+    }});
+    result.push_back({ "Solver::IsUnsatisfiable", [&fixture]() -> std::function<void()> {
+        return [&fixture]() { [[maybe_unused]] auto unsat = fixture.solver->IsUnsatisfiable(*fixture.annotation); };
+    }});
+    result.push_back({ "Solver::MakeInterferenceStable", [&fixture]() -> std::function<void()> {
+        auto pre = std::make_shared<std::unique_ptr<Annotation>>(plankton::Copy(*fixture.annotation));
+        return [&fixture, pre]() {
+            [[maybe_unused]] auto stable = fixture.interferingSolver->MakeInterferenceStable(std::move(*pre));
+        };
+    }});
+    result.push_back({ "Solver::AddInterference", [&fixture]() -> std::function<void()> {
+        auto target = std::make_shared<Solver>(*fixture.solver);
+        auto effects = std::make_shared<std::deque<std::unique_ptr<HeapEffect>>>(fixture.CopyInterference());
+        return [target, effects]() { target->AddInterference(std::move(*effects)); };
+    }});
+    if (fixture.future) {
+        result.push_back({ "Solver::ImproveFuture", [&fixture]() -> std::function<void()> {
+            auto pre = std::make_shared<std::unique_ptr<Annotation>>(plankton::Copy(*fixture.annotation));
+            return [&fixture, pre]() {
+                [[maybe_unused]] auto post = fixture.interferingSolver->ImproveFuture(std::move(*pre), *fixture.future);
+            };
+        }});
+    }
+    return result;
+}
+
+
+//
+// Main
+//
+
+int main(int argc, char** argv) {
+    try {
+        TCLAP::CmdLine cmd("PLANKTON micro benchmarks for solver primitives", ' ', "1.0");
+        TCLAP::UnlabeledValueArg<std::string> programArg("input", "Program the fixtures are built for", false, "examples/Harris.pl", "path", cmd);
+        TCLAP::ValueArg<double> minTimeArg("", "min-time", "Minimal measured time per benchmark in seconds", false, 1, "number", cmd);
+        TCLAP::ValueArg<std::size_t> minIterationsArg("", "min-iterations", "Minimal iterations per benchmark", false, 3, "integer", cmd);
+        TCLAP::ValueArg<std::string> filterArg("", "filter", "Only run benchmarks whose name contains the given string", false, "", "string", cmd);
+        TCLAP::ValueArg<std::string> fixtureArg("", "fixture", "Load the fixtures from the given file instead of building the default ones for examples/Harris.pl", false, "", "path", cmd);
+        TCLAP::ValueArg<std::string> storeFixtureArg("", "store-fixture", "Write the fixtures to the given file, to be loaded with '--fixture'", false, "", "path", cmd);
+        cmd.parse(argc, argv);
+
+        auto fixture = fixtureArg.isSet() ? Fixture(programArg.getValue(), fixtureArg.getValue()) : Fixture(programArg.getValue());
+        if (storeFixtureArg.isSet()) fixture.Store(storeFixtureArg.getValue());
+        auto minTime = std::chrono::duration<double>(minTimeArg.getValue());
+        PrintHeader();
+        for (const auto& benchmark : MakeBenchmarks(fixture)) {
+            if (benchmark.name.find(filterArg.getValue()) == std::string::npos) continue;
+            PrintResult(benchmark.name, Run(benchmark, minTime, std::max<std::size_t>(minIterationsArg.getValue(), 1)));
+        }
+        return 0;
+
+    } catch (TCLAP::ArgException& err) {
+        ERROR(err.error() << " for arg " << err.argId() << std::endl)
+        return 1;
+
+    } catch (std::logic_error& err) { // TODO: catch proper error class
+        ERROR(err.what() << std::endl)
+        return 2;
+    }
+}
@@ -0,0 +1,89 @@
+#include "engine/encoding.hpp"
+
+#include <atomic>
+#include <mutex>
+#include "internal.hpp"
+
+using namespace plankton;
+
+
+//
+// Backends
+//
+
+inline std::deque<SmtBackend> MakeDefaultBackends() {
+    std::deque<SmtBackend> result;
+    result.push_back({ "z3", "Z3's default solver", [](z3::context& context) {
+        return z3::solver(context);
+    }});
+    result.push_back({ "z3-simple", "Z3's SMT core without the incremental/non-incremental solver switching", [](z3::context& context) {
+        return z3::solver(context, z3::solver::simple());
+    }});
+    result.push_back({ "z3-mbqi", "Z3's default solver instantiating quantifiers by model-based instantiation only", [](z3::context& context) {
+        z3::solver solver(context);
+        z3::params params(context);
+        params.set("smt.mbqi", true);
+        params.set("smt.ematching", false);
+        solver.set(params);
+        return solver;
+    }});
+    result.push_back({ "z3-tactic", "Z3 preprocessing with simplify and propagate-values before the SMT core", [](z3::context& context) {
+        auto tactic = z3::tactic(context, "simplify") & z3::tactic(context, "propagate-values") & z3::tactic(context, "smt");
+        return tactic.mk_solver();
+    }});
+    return result;
+}
+
+
+//
+// Registry
+//
+
+struct SmtBackendRegistry {
+    std::mutex mutex;
+    std::deque<SmtBackend> backends; // never shrinks, references to its elements remain valid
+    std::atomic<const SmtBackend*> selected;
+
+    explicit SmtBackendRegistry() : backends(MakeDefaultBackends()), selected(&backends.front()) {}
+
+    const SmtBackend* Find(const std::string& name) {
+        for (const auto& backend : backends) {
+            if (backend.name == name) return &backend;
+        }
+        return nullptr;
+    }
+};
+
+inline SmtBackendRegistry& GetRegistry() {
+    static SmtBackendRegistry registry;
+    return registry;
+}
+
+void plankton::RegisterSmtBackend(SmtBackend backend) {
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    if (registry.Find(backend.name)) {
+        throw std::logic_error("SMT backend '" + backend.name + "' is already registered."); // TODO: better error handling
+    }
+    registry.backends.push_back(std::move(backend));
+}
+
+const SmtBackend& plankton::GetSmtBackend() {
+    return *GetRegistry().selected;
+}
+
+void plankton::SelectSmtBackend(const std::string& name) {
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    auto backend = registry.Find(name);
+    if (!backend) throw std::logic_error("Unknown SMT backend '" + name + "'."); // TODO: better error handling
+    registry.selected = backend;
+}
+
+std::vector<std::pair<std::string, std::string>> plankton::GetSmtBackends() {
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mutex);
+    std::vector<std::pair<std::string, std::string>> result;
+    for (const auto& backend : registry.backends) result.emplace_back(backend.name, backend.description);
+    return result;
+}
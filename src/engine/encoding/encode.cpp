@@ -9,6 +9,7 @@ using namespace plankton;
 
 #define CTX AsContext(internal)
 #define SOL AsSolver(internal)
+#define STORAGE AsInternal(internal)
 
 static constexpr int NULL_VALUE = 0;
 static constexpr int MIN_VALUE = -65536;
@@ -28,8 +29,8 @@ EExpr Encoding::Max() { return AsEExpr(CTX.int_val(MAX_VALUE)); }
 EExpr Encoding::Null() { return AsEExpr(CTX.int_val(NULL_VALUE)); }
 EExpr Encoding::Bool(bool val) { return AsEExpr(CTX.bool_val(val)); }
 
-EExpr Encoding::TidSelf() { return AsEExpr(CTX.constant("__SELF", EncodeSort(Sort::TID, CTX))); }
-EExpr Encoding::TidSome() { return AsEExpr(CTX.constant("__SOME", EncodeSort(Sort::TID, CTX))); }
+EExpr Encoding::TidSelf() { return AsEExpr(STORAGE.MakeConstant("__SELF", EncodeSort(Sort::TID, CTX))); }
+EExpr Encoding::TidSome() { return AsEExpr(STORAGE.MakeConstant("__SOME", EncodeSort(Sort::TID, CTX))); }
 EExpr Encoding::TidUnlocked() { return AsEExpr(CTX.int_val(UNLOCKED_VALUE)); }
 
 EExpr Encoding::Replace(const EExpr& expression, const EExpr& replace, const EExpr& with) {
@@ -62,7 +63,7 @@ EExpr Encoding::MakeAtMost(const std::vector<EExpr>& vec, unsigned int count) {
 
 
 EExpr Encoding::MakeQuantifiedVariable(Sort sort) {
-    return AsEExpr(CTX.constant("__qv", EncodeSort(sort, CTX)));
+    return AsEExpr(STORAGE.MakeConstant("__qv", EncodeSort(sort, CTX)));
 }
 
 
@@ -78,7 +79,7 @@ inline V GetOrCreate(std::map<K, V>& map, K key, F create) {
 EExpr Encoding::Encode(const VariableDeclaration& decl) {
     return GetOrCreate(variableEncoding, &decl, [this,&decl](){
         auto name = "__" + decl.name;
-        auto expr = CTX.constant(name.c_str(), EncodeSort(decl.type.sort, CTX));
+        auto expr = STORAGE.MakeConstant(name, EncodeSort(decl.type.sort, CTX));
         return AsEExpr(expr);
     });
 }
@@ -89,7 +90,7 @@ EExpr Encoding::Encode(const SymbolDeclaration& decl) {
             return GetOrCreate(symbolEncoding, &decl, [this, &decl]() {
                 // create symbol
                 auto name = "_v" + decl.name;
-                auto expr = CTX.constant(name.c_str(), EncodeSort(decl.type.sort, CTX));
+                auto expr = STORAGE.MakeConstant(name, EncodeSort(decl.type.sort, CTX));
                 // add implicit bounds on first order data values
                 switch (decl.type.sort) {
                     case Sort::DATA:
@@ -109,7 +110,7 @@ EExpr Encoding::Encode(const SymbolDeclaration& decl) {
             return GetOrCreate(symbolEncoding, &decl, [this, &decl]() {
                 // create symbol
                 auto name = "_V" + decl.name;
-                auto expr = CTX.function(name.c_str(), EncodeSort(decl.type.sort, CTX), CTX.bool_sort());
+                auto expr = STORAGE.MakeFunction(name, EncodeSort(decl.type.sort, CTX), CTX.bool_sort());
                 // add implicit bounds on data values
                 assert(decl.type.sort == Sort::DATA);
                 auto qv = AsExpr(MakeQuantifiedVariable(decl.type.sort));
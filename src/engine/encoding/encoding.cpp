@@ -1,6 +1,11 @@
 #include "engine/encoding.hpp"
 
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 #include "internal.hpp"
+#include "logics/util.hpp"
+#include "util/timer.hpp"
 
 using namespace plankton;
 
@@ -35,21 +40,127 @@ EExpr& EExpr::operator=(const EExpr& other) {
     return *this;
 }
 
+//
+// Storage pool
+//
+
+static constexpr std::size_t MAX_IDLE_STORAGES = 16;
+
+struct StoragePool {
+    std::mutex mutex;
+    std::deque<std::unique_ptr<InternalStorage>> idle; // least recently released first
+
+    std::unique_ptr<InternalStorage> Take(std::deque<std::unique_ptr<InternalStorage>>::iterator position) {
+        auto result = std::move(*position);
+        idle.erase(position);
+        return result;
+    }
+
+    std::unique_ptr<InternalStorage> Acquire() {
+        auto& backend = GetSmtBackend();
+        std::unique_ptr<InternalStorage> result;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            // prefer storages without a premise, keep the others around for later reuse unless the pool is full
+            auto find = std::find_if(idle.rbegin(), idle.rend(), [&backend](auto& storage){
+                return &AsInternal(storage).backend == &backend && !AsInternal(storage).premise;
+            });
+            if (find != idle.rend()) return Take(std::prev(find.base()));
+            // storages of other backends are never reused, they age out of the pool
+            auto evict = std::find_if(idle.begin(), idle.end(), [&backend](auto& storage){ return &AsInternal(storage).backend == &backend; });
+            if (idle.size() < MAX_IDLE_STORAGES || evict == idle.end()) return std::make_unique<Z3InternalStorage>(backend);
+            result = Take(evict);
+        }
+        AsInternal(result).DropPremise();
+        return result;
+    }
+
+    std::unique_ptr<InternalStorage> Acquire(const Formula& premise, std::size_t hash, const SolverConfig* config) {
+        auto& backend = GetSmtBackend();
+        std::lock_guard<std::mutex> guard(mutex);
+        auto find = std::find_if(idle.rbegin(), idle.rend(), [&](auto& storage){
+            return &AsInternal(storage).backend == &backend && AsInternal(storage).HasPremise(premise, hash, config);
+        });
+        if (find == idle.rend()) return nullptr;
+        return Take(std::prev(find.base()));
+    }
+
+    void Release(std::unique_ptr<InternalStorage> storage) {
+        AsInternal(storage).PopToPremise(); // keeps declarations, axioms, and the premise
+        std::unique_ptr<InternalStorage> evicted; // destroyed outside the critical section
+        std::lock_guard<std::mutex> guard(mutex);
+        if (idle.size() >= MAX_IDLE_STORAGES) {
+            evicted = std::move(idle.front());
+            idle.pop_front();
+        }
+        idle.push_back(std::move(storage));
+    }
+};
+
+inline StoragePool& GetStoragePool() {
+    static StoragePool pool;
+    return pool;
+}
+
 //
 // Encoding
 //
 
-Encoding::Encoding() : internal(std::make_unique<Z3InternalStorage>()) {
-    AsSolver(internal).add(AsExpr(TidSelf() > TidUnlocked()));
-    AsSolver(internal).add(AsExpr(TidSome() > TidUnlocked()));
+Encoding::Encoding() : internal(GetStoragePool().Acquire()) {
+    auto& storage = AsInternal(internal);
+    if (!storage.prepared) {
+        storage.solver.add(AsExpr(TidSelf() > TidUnlocked()));
+        storage.solver.add(AsExpr(TidSome() > TidUnlocked()));
+        storage.prepared = true;
+    }
+    storage.solver.push();
+}
+
+Encoding::~Encoding() {
+    if (!internal) return; // moved from
+    // expressions must not outlive their context, release them before handing the storage back
+    checks_premise.clear();
+    checks_callback.clear();
+    variableEncoding.clear();
+    symbolEncoding.clear();
+    GetStoragePool().Release(std::move(internal));
+}
+
+Encoding::Encoding(const Formula& premise) : Encoding(premise, nullptr) {
 }
 
-Encoding::Encoding(const Formula& premise) : Encoding() {
-    AddPremise(premise);
+Encoding::Encoding(const Formula& premise, const SolverConfig& config) : Encoding(premise, &config) {
 }
 
-Encoding::Encoding(const Formula& premise, const SolverConfig& config) : Encoding() {
-    AddPremise(EncodeFormulaWithKnowledge(premise, config));
+static std::atomic<std::size_t> premiseCounter{0};
+
+Encoding::Encoding(const Formula& premise, const SolverConfig* config) {
+    // reuse a storage that has the premise asserted already, if any
+    auto hash = plankton::SyntacticalHash(premise);
+    internal = GetStoragePool().Acquire(premise, hash, config);
+    if (internal) {
+        MEASURE("Encoding::Encoding ~> premise reused")
+        auto& storage = AsInternal(internal);
+        variableEncoding = storage.premiseVariables;
+        symbolEncoding = storage.premiseSymbols;
+        storage.solver.push();
+        return;
+    }
+
+    // encode the premise at its own scope such that later encodings can reuse it
+    MEASURE("Encoding::Encoding ~> premise encoded")
+    Encoding base;
+    internal = std::move(base.internal);
+    auto& storage = AsInternal(internal);
+    AddPremise(config ? EncodeFormulaWithKnowledge(premise, *config) : Encode(premise));
+    storage.premise = plankton::Copy(premise);
+    storage.premiseId = ++premiseCounter;
+    storage.premiseConfig = config ? config->id : 0;
+    storage.premiseHash = hash;
+    storage.premiseVariables = variableEncoding;
+    storage.premiseSymbols = symbolEncoding;
+    storage.premiseSize = storage.solver.assertions().size();
+    storage.solver.push();
 }
 
 Encoding::Encoding(const FlowGraph& graph) : Encoding() {
@@ -2,8 +2,11 @@
 #ifndef PLANKTON_ENGINE_INTERNAL_HPP
 #define PLANKTON_ENGINE_INTERNAL_HPP
 
+#include <functional>
+#include <map>
 #include "z3++.h"
 #include "engine/encoding.hpp"
+#include "logics/util.hpp"
 
 namespace plankton {
     
@@ -128,11 +131,79 @@ namespace plankton {
         return AsFuncDecl(expr.Repr());
     }
     
+    struct SmtBackend {
+        std::string name;
+        std::string description;
+        std::function<z3::solver(z3::context&)> makeSolver;
+    };
+
+    void RegisterSmtBackend(SmtBackend backend);
+    const SmtBackend& GetSmtBackend(); // currently selected backend, see 'plankton::SelectSmtBackend'
+
     struct Z3InternalStorage : public InternalStorage {
+        const SmtBackend& backend;
         z3::context context;
         z3::solver solver;
-    
-        explicit Z3InternalStorage() : context(), solver(context) {}
+        bool prepared = false; // whether or not the base scope of 'solver' contains the axioms every encoding relies on
+        std::map<std::pair<std::string, unsigned int>, z3::expr> constants;
+        std::map<std::pair<std::string, unsigned int>, z3::func_decl> functions;
+        std::unique_ptr<Formula> premise; // formula asserted at the first scope of 'solver', if any
+        std::size_t premiseId = 0; // unique among all premises ever asserted, 0 if none
+        std::size_t premiseConfig = 0; // id of the config the premise was encoded with, 0 if none
+        std::size_t premiseHash = 0;
+        std::map<const VariableDeclaration*, EExpr> premiseVariables; // encodings created while encoding the premise
+        std::map<const SymbolDeclaration*, EExpr> premiseSymbols;
+        std::size_t premiseSize = 0; // number of assertions up to and including the premise
+        std::deque<z3::model> premiseModels; // models of the premise, refute checks without solving
+        bool premiseConsequencesFailed = false; // whether solver::consequences failed for the premise before
+    
+        explicit Z3InternalStorage(const SmtBackend& backend) : backend(backend), context(), solver(backend.makeSolver(context)) {}
+        
+        inline z3::expr MakeConstant(const std::string& name, const z3::sort& sort) {
+            auto key = std::make_pair(name, sort.id());
+            auto find = constants.find(key);
+            if (find != constants.end()) return find->second;
+            auto result = context.constant(name.c_str(), sort);
+            constants.emplace(std::move(key), result);
+            return result;
+        }
+        
+        inline z3::func_decl MakeFunction(const std::string& name, const z3::sort& domain, const z3::sort& range) {
+            auto key = std::make_pair(name, domain.id());
+            auto find = functions.find(key);
+            if (find != functions.end()) return find->second;
+            auto result = context.function(name.c_str(), domain, range);
+            functions.emplace(std::move(key), result);
+            return result;
+        }
+        
+        inline void PopAll() {
+            auto scopes = Z3_solver_get_num_scopes(context, solver);
+            if (scopes > 0) solver.pop(scopes);
+        }
+        
+        inline void PopToPremise() {
+            unsigned int keep = premise ? 1 : 0;
+            auto scopes = Z3_solver_get_num_scopes(context, solver);
+            if (scopes > keep) solver.pop(scopes - keep);
+        }
+        
+        inline void DropPremise() {
+            PopAll();
+            premise.reset();
+            premiseId = 0;
+            premiseConfig = 0;
+            premiseHash = 0;
+            premiseVariables.clear();
+            premiseSymbols.clear();
+            premiseSize = 0;
+            premiseModels.clear();
+            premiseConsequencesFailed = false;
+        }
+        
+        [[nodiscard]] inline bool HasPremise(const Formula& formula, std::size_t hash, const SolverConfig* config) const {
+            return premise && premiseHash == hash && premiseConfig == (config ? config->id : 0) && plankton::SyntacticalEqual(*premise, formula);
+        }
         
 //        inline z3::expr_vector AsVector(const std::vector<EExpr>& vector) {
 //            z3::expr_vector result(context);
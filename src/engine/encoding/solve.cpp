@@ -4,6 +4,12 @@
 #include <random>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <set>
 #include "internal.hpp"
 #include "util/shortcuts.hpp"
 #include "util/timer.hpp"
@@ -13,6 +19,17 @@ using namespace plankton;
 static constexpr std::size_t BATCH_SIZE = 16;
 static constexpr std::size_t PARALLEL_THRESHOLD = 3 * BATCH_SIZE;
 static constexpr std::size_t FALLBACK_THREAD_COUNT = 8;
+static constexpr unsigned int NO_TIMEOUT = std::numeric_limits<unsigned int>::max();
+static constexpr std::size_t MODEL_ROUNDS = 2;
+static constexpr std::size_t MAX_CACHED_MODELS = 8;
+
+static std::atomic<unsigned int> portfolioBudget{0}; // milliseconds, 0 disables portfolio solving
+static std::atomic<unsigned int> queryTimeout{0}; // milliseconds, 0 for none
+static std::atomic<unsigned int> queryResourceLimit{0}; // Z3 rlimit, 0 for none
+static std::atomic<bool> limited{false}; // whether solvers may carry a timeout or rlimit, they are reset per query then
+
+enum struct BatchMethod { CONSEQUENCES, ASSUMPTIONS, PUSH_POP };
+static std::atomic<BatchMethod> batchMethod{BatchMethod::CONSEQUENCES};
 
 
 struct PreferredMethodFailed : std::exception {
@@ -21,6 +38,12 @@ struct PreferredMethodFailed : std::exception {
     }
 };
 
+struct BudgetExceeded : std::exception {
+    [[nodiscard]] const char* what() const noexcept override {
+        return "SMT solving failed: Z3 exceeded the time or resource budget; solving result was 'UNKNOWN'.";
+    }
+};
+
 inline z3::expr Translate(const z3::expr& expr, const z3::context& srcContext, z3::context& dstContext) {
     return z3::to_expr(dstContext, Z3_translate(srcContext, expr, dstContext));
 }
@@ -30,50 +53,194 @@ inline z3::expr Translate(const z3::expr& expr, const z3::context& srcContext, z
 // Z3 handling
 //
 
-inline bool IsUnsat(z3::solver& solver) {
+inline void ApplyLimits(z3::solver& solver, unsigned int timeout) {
+    if (!limited) return;
+    z3::params params(solver.ctx());
+    params.set("timeout", timeout > 0 ? timeout : NO_TIMEOUT);
+    params.set("rlimit", queryResourceLimit.load());
+    solver.set(params);
+}
+
+inline z3::check_result Check(z3::solver& solver, unsigned int timeout, const z3::expr_vector* assumptions = nullptr) {
+    static Timer timer("Z3 query", false);
+    auto& profiler = Profiler::Instance();
+    if (profiler.IsEnabled()) profiler.Record("Z3 query assertions", solver.assertions().size(), "assertions");
+    ApplyLimits(solver, timeout);
+    auto measurement = timer.MeasureIfInstrumented();
+    return assumptions ? solver.check(*assumptions) : solver.check();
+}
+
+inline z3::check_result Check(z3::solver& solver) {
+    return Check(solver, queryTimeout);
+}
+
+inline z3::check_result Check(z3::solver& solver, const z3::expr_vector& assumptions) {
+    return Check(solver, queryTimeout, &assumptions);
+}
+
+inline bool IsBudgetExceeded(const std::string& reasonUnknown) {
+    return reasonUnknown.find("timeout") != std::string::npos || reasonUnknown.find("canceled") != std::string::npos
+           || reasonUnknown.find("resource") != std::string::npos;
+}
+
+inline bool DismissUnknown(const std::string& reasonUnknown, CheckMode mode) {
+    // optional knowledge may be dropped, it is not implied as far as the engine is concerned
+    if (mode == CheckMode::OPTIONAL) {
+        auto& profiler = Profiler::Instance();
+        if (profiler.IsEnabled()) profiler.Record("Z3 unknown dismissed", 1, "queries");
+        return false;
+    }
+    throw std::logic_error("Solving failed: Z3 returned z3::unknown (" + reasonUnknown + ")."); // TODO: better error handling
+}
+
+void plankton::SetSmtQueryLimits(std::size_t milliseconds, std::size_t resourceLimit) {
+    queryTimeout = static_cast<unsigned int>(std::min<std::size_t>(milliseconds, NO_TIMEOUT - 1));
+    queryResourceLimit = static_cast<unsigned int>(std::min<std::size_t>(resourceLimit, NO_TIMEOUT));
+    if (queryTimeout > 0 || queryResourceLimit > 0) limited = true;
+}
+
+
+//
+// Portfolio solving
+//
+
+struct PortfolioMember {
+    std::string name;
+    std::function<void(z3::params&)> configure;
+};
+
+static const std::vector<PortfolioMember> PORTFOLIO = {
+        { "default", [](z3::params&) {} },
+        { "seed-1", [](z3::params& params) { params.set("smt.random_seed", 1u); } },
+        { "no-mbqi", [](z3::params& params) { params.set("smt.mbqi", false); } },
+        { "arith-2", [](z3::params& params) { params.set("smt.arith.solver", 2u); } },
+        { "seed-2", [](z3::params& params) { params.set("smt.random_seed", 2u); } },
+        { "mbqi-only", [](z3::params& params) { params.set("smt.ematching", false); } },
+};
+
+inline z3::check_result RacePortfolio(z3::solver& solver);
+
+inline z3::check_result CheckRacing(z3::solver& solver) {
+    // queries exceeding the budget are restarted under all portfolio configurations concurrently
+    auto budget = portfolioBudget.load();
+    auto timeout = queryTimeout.load();
+    if (budget == 0 || (timeout > 0 && timeout <= budget)) return Check(solver);
+    auto result = Check(solver, budget);
+    if (result != z3::unknown) return result;
+    return RacePortfolio(solver);
+}
+
+void plankton::SelectSmtBatchMethod(const std::string& name) {
+    if (name == "consequences") batchMethod = BatchMethod::CONSEQUENCES;
+    else if (name == "assumptions") batchMethod = BatchMethod::ASSUMPTIONS;
+    else if (name == "push-pop") batchMethod = BatchMethod::PUSH_POP;
+    else throw std::logic_error("Unknown SMT batch method '" + name + "'."); // TODO: better error handling
+}
+
+void plankton::SetSmtPortfolioBudget(std::size_t milliseconds) {
+    portfolioBudget = static_cast<unsigned int>(std::min<std::size_t>(milliseconds, NO_TIMEOUT - 1));
+    if (portfolioBudget > 0) limited = true;
+}
+
+
+//
+// Single queries
+//
+
+inline bool IsUnsat(z3::solver& solver, CheckMode mode, bool race = false) {
     solver.push();
-    auto res = solver.check();
+    auto res = race ? CheckRacing(solver) : Check(solver);
+    auto reason = res == z3::unknown ? solver.reason_unknown() : std::string();
     solver.pop();
     switch (res) {
         case z3::unsat: return true;
         case z3::sat: return false;
-        case z3::unknown: throw std::logic_error("Solving failed: Z3 returned z3::unknown."); // TODO: better error handling
+        case z3::unknown: return DismissUnknown(reason, mode);
     }
     throw;
 }
 
-inline bool IsImplied(z3::solver& solver, const z3::expr& expr) {
+inline bool IsImplied(z3::solver& solver, const z3::expr& expr, CheckMode mode, bool race = false) {
     solver.push();
     solver.add(!expr);
-    auto res = solver.check();
+    auto res = race ? CheckRacing(solver) : Check(solver);
+    auto reason = res == z3::unknown ? solver.reason_unknown() : std::string();
     solver.pop();
     switch (res) {
         case z3::unsat: return true;
         case z3::sat: return false;
-        case z3::unknown: throw std::logic_error("Solving failed: Z3 returned z3::unknown."); // TODO: better error handling
+        case z3::unknown: return DismissUnknown(reason, mode);
     }
     throw;
 }
 
 
+//
+// Assumption-based solving
+//
+
+struct GuardedChecks {
+    // checks are asserted once, guarded by a fresh literal, and decided by assuming that literal;
+    // the solver stays incremental since there is no push/pop per check
+    z3::solver& solver;
+    std::size_t counter = 0;
+
+    explicit GuardedChecks(z3::solver& solver) : solver(solver) { solver.push(); }
+    GuardedChecks(const GuardedChecks& other) = delete;
+    ~GuardedChecks() { solver.pop(); }
+
+    bool IsImplied(const z3::expr& expr, CheckMode mode) {
+        auto& context = solver.ctx();
+        std::string name = "__asm__" + std::to_string(counter++);
+        auto literal = context.bool_const(name.c_str());
+        solver.add(z3::implies(literal, !expr));
+        z3::expr_vector assumptions(context);
+        assumptions.push_back(literal);
+        switch (Check(solver, assumptions)) {
+            case z3::unsat: return true;
+            case z3::sat: return false;
+            case z3::unknown: break;
+        }
+        auto reason = solver.reason_unknown();
+        if (IsBudgetExceeded(reason)) return DismissUnknown(reason, mode);
+        return ::IsImplied(solver, expr, mode); // give Z3 another chance without assumptions
+    }
+};
+
+
 //
 // Batch solving
 //
 
-inline std::vector<bool> ComputeImpliedOneAtATimeSequential(z3::solver& solver, const std::deque<EExpr>& expressions);
-inline std::vector<bool> ComputeImpliedOneAtATimeParallel(z3::solver& solver, const std::deque<EExpr>& expressions);
+inline std::vector<bool> ComputeImpliedWithAssumptions(z3::solver& solver, const std::deque<EExpr>& expressions, CheckMode mode);
+inline std::vector<bool> ComputeImpliedWithPushPop(z3::solver& solver, const std::deque<EExpr>& expressions, CheckMode mode);
+inline std::vector<bool> ComputeImpliedOneAtATimeParallel(Z3InternalStorage& storage, const std::deque<EExpr>& expressions, CheckMode mode, bool guarded);
+
+inline std::vector<bool> ComputeImpliedOneAtATime(Z3InternalStorage& storage, const std::deque<EExpr>& expressions, CheckMode mode) {
+    // checks are guarded by assumption literals unless push/pop is selected explicitly
+    auto& solver = storage.solver;
+    auto guarded = batchMethod != BatchMethod::PUSH_POP;
+    if (Check(solver) == z3::unsat) return std::vector<bool>(expressions.size(), true);
+    if (expressions.size() >= PARALLEL_THRESHOLD) return ComputeImpliedOneAtATimeParallel(storage, expressions, mode, guarded);
+    else if (guarded) return ComputeImpliedWithAssumptions(solver, expressions, mode);
+    else return ComputeImpliedWithPushPop(solver, expressions, mode);
+}
 
-inline std::vector<bool> ComputeImpliedOneAtATime(z3::solver& solver, const std::deque<EExpr>& expressions) {
-    if (solver.check() == z3::unsat) return std::vector<bool>(expressions.size(), true);
-    if (expressions.size() < PARALLEL_THRESHOLD) return ComputeImpliedOneAtATimeSequential(solver, expressions);
-    else return ComputeImpliedOneAtATimeParallel(solver, expressions);
+inline std::vector<bool> ComputeImpliedWithAssumptions(z3::solver& solver, const std::deque<EExpr>& expressions, CheckMode mode) {
+    std::vector<bool> result;
+    result.reserve(expressions.size());
+    GuardedChecks checks(solver);
+    for (const auto& check : expressions) {
+        result.push_back(checks.IsImplied(AsExpr(check), mode));
+    }
+    return result;
 }
 
-inline std::vector<bool> ComputeImpliedOneAtATimeSequential(z3::solver& solver, const std::deque<EExpr>& expressions) {
+inline std::vector<bool> ComputeImpliedWithPushPop(z3::solver& solver, const std::deque<EExpr>& expressions, CheckMode mode) {
     std::vector<bool> result;
     result.reserve(expressions.size());
     for (const auto& check : expressions) {
-        result.push_back(IsImplied(solver, AsExpr(check)));
+        result.push_back(IsImplied(solver, AsExpr(check), mode));
     }
     return result;
 }
@@ -84,90 +251,366 @@ inline std::size_t GetThreadCount() {
     return FALLBACK_THREAD_COUNT;
 }
 
-struct Task {
-    std::size_t id;
-    z3::expr expr;
-    explicit Task(std::size_t id, const z3::expr& expr) : id(id), expr(expr) {}
+struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
 };
 
-struct Result {
-    std::size_t id;
-    bool implied;
-    Result(const Task& task, bool implied) : id(task.id), implied(implied) {}
+struct Worker {
+    z3::context context;
+    std::unique_ptr<z3::solver> solver; // made by the backend of the latest job
+    const SmtBackend* backend = nullptr;
+    bool scoped = false; // whether the first scope of 'solver' is pushed for a premise
+    std::size_t premiseId = 0; // premise translated into that scope, 0 if none or incomplete
+
+    z3::solver& Prepare(const SmtBackend& jobBackend) {
+        if (backend != &jobBackend) {
+            backend = &jobBackend;
+            solver = std::make_unique<z3::solver>(backend->makeSolver(context));
+            scoped = false;
+            premiseId = 0;
+        }
+        return *solver;
+    }
+
+    void DropPremise() {
+        if (scoped) solver->pop();
+        scoped = false;
+        premiseId = 0;
+    }
 };
 
-struct TaskPool {
-    z3::context& srcContext;
-    z3::solver& srcSolver;
-    std::vector<Task> tasks;
-    std::vector<Result> results;
-    std::mutex takeMutex;
-    std::mutex putMutex;
+inline z3::expr MakeConjunction(const z3::expr_vector& assertions, unsigned int begin, unsigned int end) {
+    z3::expr_vector result(assertions.ctx());
+    for (auto index = begin; index < end; ++index) result.push_back(assertions[(int) index]);
+    return z3::mk_and(result);
+}
 
-    explicit TaskPool(const std::deque<EExpr>& expressions, z3::solver& solver) : srcContext(solver.ctx()), srcSolver(solver) {
+struct PoolJob {
+    std::size_t active = 0; // guarded by pool mutex
+    bool exhausted = false; // guarded by pool mutex
+
+    virtual ~PoolJob() = default;
+    virtual void Process(Worker& worker) = 0;
+    [[nodiscard]] virtual bool IsDepleted() const = 0; // whether a worker returning from 'Process' ends the job
+};
+
+struct Job final : public PoolJob {
+    const SmtBackend& backend;
+    CheckMode mode;
+    bool guarded; // whether checks are decided by assumption literals or by push/pop
+    z3::context& srcContext;
+    std::mutex srcMutex; // guards 'srcContext' against concurrent translations
+    std::size_t premiseId; // pooled premise of the source storage, workers keep it across jobs; 0 if none
+    z3::expr premise; // assertions up to and including the pooled premise
+    z3::expr remainder; // assertions following the pooled premise
+    std::vector<z3::expr> tasks;
+    std::deque<TaskQueue> queues;
+    std::vector<std::uint8_t> results;
+    std::atomic<std::size_t> nextQueue{0};
+    std::exception_ptr error; // guarded by 'srcMutex'
+    std::string profileScope = Profiler::CurrentScope(); // workers report to the scope of the caller
+
+    explicit Job(Z3InternalStorage& storage, const std::deque<EExpr>& expressions, CheckMode mode, bool guarded, std::size_t threadCount)
+            : backend(storage.backend), mode(mode), guarded(guarded), srcContext(storage.context), premiseId(storage.premise ? storage.premiseId : 0),
+              premise(storage.context), remainder(storage.context), results(expressions.size(), false) {
+        auto assertions = storage.solver.assertions();
+        auto split = premiseId != 0 ? static_cast<unsigned int>(storage.premiseSize) : 0;
+        premise = MakeConjunction(assertions, 0, split);
+        remainder = MakeConjunction(assertions, split, assertions.size());
         tasks.reserve(expressions.size());
-        for (std::size_t index = 0; index < expressions.size(); ++index) {
-            tasks.emplace_back(index, AsExpr(expressions.at(index)));
+        for (const auto& expr : expressions) tasks.push_back(AsExpr(expr));
+
+        // distribute shuffled batches round-robin over the queues, workers steal from one another when running dry
+        std::vector<std::size_t> order(tasks.size());
+        for (std::size_t index = 0; index < order.size(); ++index) order[index] = index;
+        std::shuffle(order.begin(), order.end(), std::default_random_engine());
+        auto queueCount = std::min(threadCount, (order.size() + BATCH_SIZE - 1) / BATCH_SIZE);
+        queues.resize(std::max<std::size_t>(queueCount, 1));
+        for (std::size_t index = 0; index < order.size(); ++index) {
+            queues[(index / BATCH_SIZE) % queues.size()].tasks.push_back(order[index]);
         }
-        std::shuffle(tasks.begin(), tasks.end(), std::default_random_engine());
     }
 
-    std::vector<Task> Take(z3::solver& dstSolver) {
-        std::lock_guard guard(takeMutex);
-        auto& dstContext = dstSolver.ctx();
-        auto result = plankton::MakeVector<Task>(BATCH_SIZE);
-        for (std::size_t index = 0; index < BATCH_SIZE && !tasks.empty(); ++index) {
-            result.push_back(tasks.back());
-            result.back().expr = Translate(result.back().expr, srcContext, dstContext);
-            tasks.pop_back();
+    std::vector<std::size_t> Take(std::size_t own) {
+        auto result = plankton::MakeVector<std::size_t>(BATCH_SIZE);
+        if (own < queues.size()) {
+            auto& queue = queues[own];
+            std::lock_guard guard(queue.mutex);
+            while (result.size() < BATCH_SIZE && !queue.tasks.empty()) {
+                result.push_back(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            if (!result.empty()) return result;
+        }
+        for (std::size_t offset = 1; offset <= queues.size(); ++offset) {
+            auto& queue = queues[(own + offset) % queues.size()];
+            std::lock_guard guard(queue.mutex);
+            while (result.size() < BATCH_SIZE && !queue.tasks.empty()) {
+                result.push_back(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            if (!result.empty()) return result;
         }
         return result;
     }
 
-    void Put(std::vector<Result> res) {
-        std::lock_guard guard(putMutex);
-        plankton::MoveInto(std::move(res), results);
+    bool IsDrained() {
+        for (auto& queue : queues) {
+            std::lock_guard guard(queue.mutex);
+            if (!queue.tasks.empty()) return false;
+        }
+        return true;
+    }
+
+    void Abort(std::exception_ptr exception) {
+        {
+            std::lock_guard guard(srcMutex);
+            if (!error) error = std::move(exception);
+        }
+        for (auto& queue : queues) {
+            std::lock_guard guard(queue.mutex);
+            queue.tasks.clear();
+        }
+    }
+
+    void Translate(Worker& worker, z3::expr& translatedRemainder, std::vector<z3::expr>& translatedTasks) {
+        // a single critical section per worker and job; the premise is translated only if the worker's one is outdated
+        auto& context = worker.context;
+        auto reuse = premiseId != 0 && worker.premiseId == premiseId;
+        std::lock_guard guard(srcMutex);
+        if (!reuse) {
+            worker.DropPremise();
+            if (premiseId != 0) {
+                worker.solver->push();
+                worker.scoped = true;
+                worker.solver->add(::Translate(premise, srcContext, context));
+                worker.premiseId = premiseId;
+            }
+        }
+        translatedRemainder = ::Translate(remainder, srcContext, context);
+        translatedTasks.reserve(tasks.size());
+        for (const auto& task : tasks) translatedTasks.push_back(::Translate(task, srcContext, context));
+
+        auto& profiler = Profiler::Instance();
+        if (profiler.IsEnabled()) profiler.Record(reuse ? "Z3 worker premise reused" : "Z3 worker premise translated", 1, "jobs");
+    }
+
+    [[nodiscard]] bool IsDepleted() const override {
+        return true; // workers return once all queues are drained
+    }
+
+    void Process(Worker& worker) override {
+        Profiler::Scope scope(profileScope);
+        auto own = nextQueue++;
+        if (IsDrained()) return; // joined late, spare the translation
+        auto& solver = worker.Prepare(backend);
+        auto translatedRemainder = worker.context.bool_val(true);
+        std::vector<z3::expr> translatedTasks;
+        try {
+            Translate(worker, translatedRemainder, translatedTasks);
+        } catch (...) {
+            Abort(std::current_exception());
+            return;
+        }
+        solver.push();
+        try {
+            solver.add(translatedRemainder);
+            GuardedChecks checks(solver);
+            while (true) {
+                auto batch = Take(own);
+                if (batch.empty()) break;
+                for (auto index : batch) {
+                    const auto& task = translatedTasks[index];
+                    results[index] = guarded ? checks.IsImplied(task, mode) : ::IsImplied(solver, task, mode);
+                }
+            }
+        } catch (...) {
+            Abort(std::current_exception());
+        }
+        solver.pop();
     }
 };
 
-inline void Work(TaskPool& pool) {
-    z3::context context;
-    z3::solver solver(context);
-    std::unique_lock guard(pool.takeMutex);
-    auto premise = z3::mk_and(pool.srcSolver.assertions());
-    solver.add(Translate(premise, pool.srcContext, context));
-    guard.unlock();
-
-    while (true) {
-        auto tasks = pool.Take(solver);
-        if (tasks.empty()) break;
-        auto results = plankton::MakeVector<Result>(tasks.size());
-        for (const auto& task : tasks) {
-            bool implied = IsImplied(solver, task.expr);
-            // DEBUG("." << std::flush)
-            results.emplace_back(task, implied);
+struct WorkerPool {
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable finished;
+    std::deque<PoolJob*> jobs;
+    std::deque<std::thread> threads;
+    std::size_t idle = 0; // guarded by 'mutex'
+    bool shutdown = false;
+
+    explicit WorkerPool(std::size_t threadCount) {
+        for (std::size_t index = 0; index < threadCount; ++index) {
+            threads.emplace_back([this](){ Work(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard guard(mutex);
+            shutdown = true;
         }
-        pool.Put(std::move(results));
+        wakeup.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    void Work() {
+        Worker worker;
+        std::unique_lock guard(mutex);
+        while (true) {
+            idle++;
+            wakeup.wait(guard, [this](){ return shutdown || !jobs.empty(); });
+            idle--;
+            if (shutdown) return;
+            auto& job = *jobs.front();
+            job.active++;
+            guard.unlock();
+            job.Process(worker);
+            guard.lock();
+            job.active--;
+            if (!job.exhausted && job.IsDepleted()) {
+                job.exhausted = true;
+                jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+            }
+            if (job.active == 0) finished.notify_all();
+        }
+    }
+
+    [[nodiscard]] std::size_t CountIdle() {
+        // every queued job claims at least one of the idle workers
+        std::lock_guard guard(mutex);
+        return idle > jobs.size() ? idle - jobs.size() : 0;
+    }
+
+    void Submit(PoolJob& job) {
+        std::lock_guard guard(mutex);
+        jobs.push_back(&job);
+        wakeup.notify_all();
+    }
+
+    void Wait(PoolJob& job) {
+        std::unique_lock guard(mutex);
+        finished.wait(guard, [&job](){ return job.exhausted && job.active == 0; });
     }
+
+    void Run(PoolJob& job) {
+        Submit(job);
+        Wait(job);
+    }
+};
+
+static const std::size_t THREAD_COUNT = GetThreadCount();
+
+inline WorkerPool& GetWorkerPool() {
+    static WorkerPool workerPool(THREAD_COUNT);
+    return workerPool;
 }
 
-inline std::vector<bool> ComputeImpliedOneAtATimeParallel(z3::solver& solver, const std::deque<EExpr>& expressions) {
-    static const std::size_t THREAD_COUNT = GetThreadCount();
+inline std::vector<bool> ComputeImpliedOneAtATimeParallel(Z3InternalStorage& storage, const std::deque<EExpr>& expressions, CheckMode mode, bool guarded) {
+    Job job(storage, expressions, mode, guarded, THREAD_COUNT);
+    GetWorkerPool().Run(job);
+    if (job.error) std::rethrow_exception(job.error);
 
-    // DEBUG("#threads=" << THREAD_COUNT << " #expr=" << expressions.size() << " " << std::flush)
-    TaskPool taskPool(expressions, solver);
-    std::deque<std::thread> threads;
-    for (std::size_t index = 0; index < THREAD_COUNT; ++index) {
-        threads.emplace_back([&taskPool](){
-            Work(taskPool);
-        });
+    return std::vector<bool>(job.results.begin(), job.results.end());
+}
+
+
+//
+// Portfolio racing on the worker pool
+//
+
+struct PortfolioJob final : public PoolJob {
+    const SmtBackend& backend;
+    z3::context& srcContext;
+    z3::expr premise;
+    std::size_t count; // number of members racing
+    std::atomic<std::size_t> nextMember{0};
+    std::string profileScope = Profiler::CurrentScope(); // workers report to the scope of the caller
+    std::mutex mutex; // guards 'srcContext' and the members' state below
+    std::condition_variable decided;
+    std::size_t pending; // members not yet finished
+    std::set<z3::context*> running; // contexts of members currently checking, they may be interrupted
+    std::optional<std::size_t> winner;
+    z3::check_result result = z3::unknown;
+
+    explicit PortfolioJob(z3::solver& solver, std::size_t count)
+            : backend(GetSmtBackend()), srcContext(solver.ctx()), premise(z3::mk_and(solver.assertions())),
+              count(count), pending(count) {}
+
+    [[nodiscard]] bool IsDepleted() const override {
+        return nextMember.load() >= count;
     }
-    for (auto& thread : threads) thread.join();
-    // DEBUG(std::endl)
 
-    std::vector<bool> result(expressions.size());
-    for (const auto& elem : taskPool.results) result.at(elem.id) = elem.implied;
-    return result;
+    void Process(Worker& worker) override {
+        auto index = nextMember++;
+        if (index >= count) return;
+        Profiler::Scope scope(profileScope);
+
+        // members use a solver of their own, the worker's one keeps its premise and configuration
+        auto& context = worker.context;
+        auto answer = z3::unknown;
+        try {
+            auto member = backend.makeSolver(context);
+            z3::params params(context);
+            PORTFOLIO[index].configure(params);
+            member.set(params);
+            ApplyLimits(member, queryTimeout);
+            bool start;
+            {
+                std::lock_guard guard(mutex);
+                start = !winner;
+                if (start) {
+                    member.add(::Translate(premise, srcContext, context));
+                    running.insert(&context);
+                }
+            }
+            if (start) answer = member.check();
+        } catch (const z3::exception&) {
+            // interrupted or misconfigured, the other members may still succeed
+        }
+
+        std::lock_guard guard(mutex);
+        running.erase(&context);
+        pending--;
+        if (answer != z3::unknown && !winner) {
+            winner = index;
+            result = answer;
+        }
+        decided.notify_all();
+    }
+};
+
+inline z3::check_result RacePortfolio(z3::solver& solver) {
+    // members run on idle workers only, without idle workers the query continues under the default configuration
+    auto& pool = GetWorkerPool();
+    auto count = std::min(PORTFOLIO.size(), pool.CountIdle());
+    auto& profiler = Profiler::Instance();
+    if (count == 0) {
+        if (profiler.IsEnabled()) profiler.Record("Z3 portfolio skipped", 1, "queries");
+        return Check(solver);
+    }
+
+    static Timer timer("Z3 portfolio", false);
+    auto measurement = timer.MeasureIfInstrumented();
+    PortfolioJob job(solver, count);
+    pool.Submit(job);
+
+    // stop the remaining members once decided; interrupts may precede a member's check, so repeat them
+    {
+        std::unique_lock guard(job.mutex);
+        job.decided.wait(guard, [&job]() { return job.winner || job.pending == 0; });
+        while (job.pending > 0) {
+            for (auto* context : job.running) context->interrupt();
+            job.decided.wait_for(guard, std::chrono::milliseconds(1));
+        }
+    }
+    pool.Wait(job);
+
+    if (profiler.IsEnabled()) profiler.Record("Z3 portfolio members", count, "members");
+    if (profiler.IsEnabled() && job.winner) profiler.Record("Z3 portfolio winner " + PORTFOLIO[*job.winner].name, 1, "queries");
+    return job.result;
 }
 
 
@@ -192,13 +635,20 @@ inline std::vector<bool> ComputeImpliedInOneShot(z3::solver& solver, const std::
     }
 
     // check
-    auto answer = solver.consequences(assumptions, variables, consequences);
+    auto answer = [&]() {
+        static Timer timer("Z3 consequences", false);
+        ApplyLimits(solver, queryTimeout);
+        auto measurement = timer.MeasureIfInstrumented();
+        return solver.consequences(assumptions, variables, consequences);
+    }();
+    auto reason = answer == z3::unknown ? solver.reason_unknown() : std::string();
     solver.pop();
 
     // create result
     std::vector<bool> result(expressions.size(), false);
     switch (answer) {
         case z3::unknown:
+            if (limited && IsBudgetExceeded(reason)) throw BudgetExceeded();
             throw PreferredMethodFailed();
 
         case z3::unsat:
@@ -241,22 +691,36 @@ inline std::string GetZ3Version() {
 }
 
 struct MethodChooser {
-    // TODO: identify working method beforehand (during construction)
-    bool fallback = false;
+    // solver::consequences is preferred, batches it fails on are decided one check at a time instead;
+    // batches on a premise it failed on before go one at a time right away
+    std::atomic<bool> warned{false};
+
+    inline void Warn() {
+        if (warned.exchange(true)) return;
+        std::stringstream warning;
+        warning << "solving failure with Z3's solver::consequences! "
+                << "This issue is known to happen for versions >4.8.7, your version is " << GetZ3Version()
+                << ". Using fallback for affected batches, performance may degrade..." << std::endl;
+        WARNING(warning.str())
+        static LateWarning lateWarning(warning.str());
+    }
 
-    inline std::vector<bool> operator()(z3::solver& solver, const std::deque<EExpr>& expressions) {
-        if (fallback) return ComputeImpliedOneAtATime(solver, expressions);
+    inline std::vector<bool> operator()(Z3InternalStorage& storage, const std::deque<EExpr>& expressions, CheckMode mode) {
+        auto& solver = storage.solver;
+        if (batchMethod != BatchMethod::CONSEQUENCES || storage.premiseConsequencesFailed) {
+            return ComputeImpliedOneAtATime(storage, expressions, mode);
+        }
         try {
             return ComputeImpliedInOneShot(solver, expressions);
+        } catch (const BudgetExceeded& err) {
+            // the batch as a whole is too hard, the one-at-a-time method gives every check its own budget
+            return ComputeImpliedOneAtATime(storage, expressions, mode);
         } catch (const PreferredMethodFailed& err) {
-            std::stringstream warning;
-            warning << "solving failure with Z3's solver::consequences! "
-                    << "This issue is known to happen for versions >4.8.7, your version is " << GetZ3Version()
-                    << ". Using fallback, performance may degrade..." << std::endl;
-            WARNING(warning.str())
-            static LateWarning lateWarning(warning.str());
-            fallback = true;
-            return ComputeImpliedOneAtATime(solver, expressions);
+            Warn();
+            if (storage.premise) storage.premiseConsequencesFailed = true;
+            auto& profiler = Profiler::Instance();
+            if (profiler.IsEnabled()) profiler.Record("Z3 consequences failed", 1, "batches");
+            return ComputeImpliedOneAtATime(storage, expressions, mode);
         }
     }
 } solvingMethod;
@@ -315,36 +779,127 @@ struct MethodChooser {
 //     return solvingMethod(wrapper.solver, wrapper.Translate(expressions));
 // }
 
-inline bool IsUnsat(std::unique_ptr<InternalStorage>& internal) {
+inline bool IsUnsat(std::unique_ptr<InternalStorage>& internal, CheckMode mode) {
     auto& solver = AsSolver(internal);
     solver.push();
-    auto result = IsUnsat(solver);
+    auto result = IsUnsat(solver, mode, true);
     solver.pop();
     return result;
 }
 
-inline bool IsImplied(std::unique_ptr<InternalStorage>& internal, const EExpr& expression) {
+inline bool IsImplied(std::unique_ptr<InternalStorage>& internal, const EExpr& expression, CheckMode mode) {
     auto& solver = AsSolver(internal);
     solver.push();
-    auto result = IsImplied(solver, AsExpr(expression));
+    auto result = IsImplied(solver, AsExpr(expression), mode, true);
     solver.pop();
     return result;
 }
 
-inline std::vector<bool> ComputeImplied(std::unique_ptr<InternalStorage>& internal, const std::deque<EExpr>& expressions) {
-    auto& solver = AsSolver(internal);
+
+
+//
+// Model-guided elimination
+//
+
+struct ModelFilter {
+    // checks that fail in some model of the solver's assertions are not implied, the solver decides the others only
+    z3::solver& solver;
+    const std::deque<EExpr>& expressions;
+    std::deque<z3::model> local;
+    bool reusable;
+    std::deque<z3::model>& models;
+    std::vector<bool> result;
+    std::vector<std::size_t> undecided; // positions in 'expressions'
+
+    explicit ModelFilter(Z3InternalStorage& storage, const std::deque<EExpr>& expressions)
+            : solver(storage.solver), expressions(expressions), reusable(IsReusable(storage)), models(reusable ? storage.premiseModels : local),
+              result(expressions.size(), false) {
+        undecided.reserve(expressions.size());
+        for (std::size_t index = 0; index < expressions.size(); ++index) undecided.push_back(index);
+    }
+
+    static bool IsReusable(const Z3InternalStorage& storage) {
+        // models of the premise are models of the solver as long as nothing else is asserted
+        return storage.premise && storage.solver.assertions().size() == storage.premiseSize;
+    }
+
+    bool Filter() {
+        // returns true if all checks are decided
+        auto count = undecided.size();
+        if (models.empty() && reusable && undecided.size() > 1) {
+            // a model of the bare premise pays off only if it may spare several checks and is kept for later batches
+            RecordProbe("Z3 model probes of premise");
+            switch (Check(solver)) {
+                case z3::unsat: return AcceptUndecided();
+                case z3::sat: AddModel(solver.get_model()); break;
+                case z3::unknown: return false;
+            }
+        }
+        for (const auto& model : models) Refute(model);
+        for (std::size_t round = 0; round < MODEL_ROUNDS && undecided.size() > 1; ++round) {
+            // look for a model refuting some of the remaining checks, there is none if all of them are implied
+            z3::expr_vector checks(solver.ctx());
+            for (auto index : undecided) checks.push_back(AsExpr(expressions[index]));
+            solver.push();
+            solver.add(!z3::mk_and(checks));
+            RecordProbe("Z3 model probes of checks");
+            auto answer = Check(solver);
+            if (answer == z3::sat) AddModel(solver.get_model());
+            solver.pop();
+            if (answer == z3::unsat) return AcceptUndecided();
+            if (answer == z3::unknown) break;
+            Refute(models.back());
+        }
+        auto& profiler = Profiler::Instance();
+        if (profiler.IsEnabled()) profiler.Record("Z3 checks refuted by models", count - undecided.size(), "checks");
+        return undecided.empty();
+    }
+
+    static void RecordProbe(const std::string& name) {
+        auto& profiler = Profiler::Instance();
+        if (profiler.IsEnabled()) profiler.Record(name, 1, "queries");
+    }
+
+    void AddModel(z3::model model) {
+        if (models.size() >= MAX_CACHED_MODELS) models.pop_front();
+        models.push_back(std::move(model));
+    }
+
+    void Refute(const z3::model& model) {
+        plankton::RemoveIf(undecided, [this, &model](auto index) {
+            return model.eval(AsExpr(expressions[index]), true).is_false();
+        });
+    }
+
+    bool AcceptUndecided() {
+        for (auto index : undecided) result[index] = true;
+        undecided.clear();
+        return true;
+    }
+};
+
+inline std::vector<bool> ComputeImplied(std::unique_ptr<InternalStorage>& internal, const std::deque<EExpr>& expressions, CheckMode mode) {
+    if (expressions.empty()) return {};
+    auto& storage = AsInternal(internal);
+    auto& solver = storage.solver;
+    ModelFilter filter(storage, expressions);
     solver.push();
-    auto result = solvingMethod(solver, expressions);
+    if (!filter.Filter()) {
+        std::deque<EExpr> remaining;
+        for (auto index : filter.undecided) remaining.push_back(expressions[index]);
+        auto implied = solvingMethod(storage, remaining, mode);
+        for (std::size_t index = 0; index < implied.size(); ++index) filter.result[filter.undecided[index]] = implied[index];
+    }
     solver.pop();
-    return result;
+    return std::move(filter.result);
 }
 
 
-void Encoding::Check() {
+void Encoding::Check(CheckMode mode) {
     MEASURE("Encoding::Check")
     assert(checks_premise.size() == checks_callback.size());
     if (checks_premise.empty()) return;
-    auto implied = ComputeImplied(internal, checks_premise);
+    auto implied = ComputeImplied(internal, checks_premise, mode);
     for (std::size_t index = 0; index < implied.size(); ++index) {
         checks_callback.at(index)(implied.at(index));
     }
@@ -352,15 +907,15 @@ void Encoding::Check() {
     checks_callback.clear();
 }
 
-bool Encoding::Implies(const EExpr& expr) {
+bool Encoding::Implies(const EExpr& expr, CheckMode mode) {
     MEASURE("Encoding::Implies")
-    auto result = IsImplied(internal, expr);
+    auto result = IsImplied(internal, expr, mode);
     return result;
 }
 
-bool Encoding::ImpliesFalse() {
+bool Encoding::ImpliesFalse(CheckMode mode) {
     MEASURE("Encoding::ImpliesFalse")
-    auto result = IsUnsat(internal);
+    auto result = IsUnsat(internal, mode);
     return result;
 }
 
@@ -381,7 +936,7 @@ std::set<const SymbolDeclaration*> Encoding::ComputeNonNull(std::set<const Symbo
 
     std::deque<EExpr> expressions;
     for (const auto* elem : symbols) expressions.push_back(EncodeIsNonNull(*elem));
-    auto implied = ComputeImplied(internal, expressions);
+    auto implied = ComputeImplied(internal, expressions, CheckMode::STRICT);
     
     auto sym = symbols.begin();
     for (bool isNonNull : implied) {
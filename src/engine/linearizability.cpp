@@ -1,11 +1,16 @@
 #include "engine/linearizability.hpp"
 
+#include "engine/encoding.hpp"
 #include "engine/proof.hpp"
 
 using namespace plankton;
 
 
 bool plankton::IsLinearizable(const Program& program, const SolverConfig& config, EngineSetup setup) {
+    plankton::SelectSmtBackend(setup.smtBackend);
+    plankton::SelectSmtBatchMethod(setup.smtBatchMethod);
+    plankton::SetSmtPortfolioBudget(setup.smtPortfolioBudget);
+    plankton::SetSmtQueryLimits(setup.smtTimeout, setup.smtResourceLimit);
     ProofGenerator proof(program, config, setup);
     proof.GenerateProof();
     return true;
@@ -1,10 +1,11 @@
 #include "engine/proof.hpp"
 
+#include <atomic>
+#include <thread>
 #include "programs/util.hpp"
 #include "logics/util.hpp"
 #include "util/shortcuts.hpp"
 #include "util/timer.hpp"
-#include "test.hpp"
 
 using namespace plankton;
 
@@ -14,43 +15,36 @@ using namespace plankton;
 //
 
 void ProofGenerator::GenerateProof() {
-    // TODO: remove debug
-    // newInterference = plankton::MakeTestInterference(*program.types.at(0));
-    // ConsolidateNewInterference();
-
-    // auto [annotation, command] = plankton::MakeTestState(program);
-    // for (std::size_t index = 0; index < 5; ++index){
-    //     Timer timer("test");
-    //     auto measurement = timer.Measure();
-    //     auto post = solver.Post(plankton::Copy(*annotation), *command, false);
-    // }
-    // throw std::logic_error("---point du break---");
     // TODO: check initializer
 
     INFO(infoPrefix << "Proof generation for '" << program.name << "' initiated." << std::endl)
-    INFO(infoPrefix << "Starting with empty interference set." << std::endl)
-    if (futureSuggestions.empty()) {
+    LoadProofCache();
+    LoadInterferenceSeed();
+    if (solver.GetInterference().empty()) INFO(infoPrefix << "Starting with empty interference set." << std::endl)
+    if (futureSuggestions->empty()) {
         INFO(infoPrefix << "Using no future suggestions." << std::endl)
     } else {
-        INFO(infoPrefix << "Using the following future suggestions (" << futureSuggestions.size() << "): " << std::endl)
-        for (const auto& suggestion : futureSuggestions) INFO(infoPrefix << "   " << *suggestion << std::endl)
+        INFO(infoPrefix << "Using the following future suggestions (" << futureSuggestions->size() << "): " << std::endl)
+        for (const auto& suggestion : *futureSuggestions) INFO(infoPrefix << "   " << *suggestion << std::endl)
     }
 
     // check API functions
     for (std::size_t counter = 0; counter < setup.proofMaxIterations; ++counter) {
         infoPrefix.Push("iter-", counter);
+        Profiler::Scope profileScope("iteration " + std::to_string(counter));
         INFO(infoPrefix << "Starting iteration " << counter << " of fixed-point iteration..." << std::endl)
 
         program.Accept(*this);
         if (!ConsolidateNewInterference()) {
             INFO(infoPrefix << "Fixed-point reached." << std::endl)
+            Profiler::Instance().Record("Interference size", solver.GetInterference().size(), "effects");
             infoPrefix.Pop();
             INFO(infoPrefix << "Proof generation was successful!" << std::endl)
-
+            StoreProofCache();
+            StoreInterference();
             return;
         }
 
-        macroPostTable.clear();
         infoPrefix.Pop();
     }
     throw std::logic_error("Aborting: proof does not seem to stabilize."); // TODO: remove / better error handling
@@ -58,11 +52,69 @@ void ProofGenerator::GenerateProof() {
 
 void ProofGenerator::Visit([[maybe_unused]] const Program& object) {
     assert(&object == &program);
+    if (setup.proofJobs > 1 && program.apiFunctions.size() > 1) {
+        HandleInterfaceFunctionsConcurrently();
+        return;
+    }
     for (const auto& function : program.apiFunctions) {
         HandleInterfaceFunction(*function);
     }
 }
 
+void ProofGenerator::HandleInterfaceFunctionsConcurrently() {
+    // every function is handled by a worker with its own solver state, sharing nothing but the current interference
+    const auto& functions = program.apiFunctions;
+    std::vector<std::unique_ptr<ProofGenerator>> workers;
+    std::vector<std::exception_ptr> errors(functions.size());
+    for (std::size_t index = 0; index < functions.size(); ++index) {
+        workers.emplace_back(new ProofGenerator(*this));
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto profileScope = Profiler::CurrentScope();
+    auto work = [&functions, &workers, &errors, &next, &profileScope]() {
+        Profiler::Scope scope(profileScope);
+        for (auto index = next++; index < functions.size(); index = next++) {
+            try {
+                workers.at(index)->HandleInterfaceFunction(*functions.at(index));
+            } catch (...) {
+                errors.at(index) = std::current_exception();
+            }
+        }
+    };
+    std::deque<std::thread> threads;
+    for (std::size_t index = 0; index < std::min(setup.proofJobs, functions.size()); ++index) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) thread.join();
+
+    // merge in function order, so that interference and tables do not depend on the order in which workers finish
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    std::map<const Function*, std::size_t> tabulated;
+    for (const auto& [function, table] : macroPostTable) tabulated[function] = table.entries.size();
+    for (auto& worker : workers) {
+        AddNewInterference(std::move(worker->newInterference));
+        for (auto& [function, table] : worker->macroPostTable) {
+            auto known = tabulated.count(function) != 0 ? tabulated.at(function) : 0;
+            auto& target = macroPostTable[function];
+            for (auto index = known; index < table.entries.size(); ++index) {
+                auto& entry = table.entries.at(index);
+                if (target.Contains(entry)) continue; // another worker tabulated the same call
+                target.Add(std::move(entry));
+            }
+        }
+        timePost.Merge(worker->timePost);
+        timeJoin.Merge(worker->timeJoin);
+        timeInterference.Merge(worker->timeInterference);
+        timePastImprove.Merge(worker->timePastImprove);
+        timePastReduce.Merge(worker->timePastReduce);
+        timeFutureImprove.Merge(worker->timeFutureImprove);
+        timeFutureReduce.Merge(worker->timeFutureReduce);
+    }
+}
+
 //
 // Common api/macro function handling
 //
@@ -153,6 +205,7 @@ void ProofGenerator::HandleInterfaceFunction(const Function& function) {
     assert(function.kind == Function::Kind::API);
 
     infoPrefix.Push("fun-", function.name);
+    Profiler::Scope profileScope("function " + function.name);
     INFO(infoPrefix << "Handling function '" << function.name << "'..." << std::endl)
 	DEBUG(std::endl << std::endl << std::endl << std::endl << std::endl)
 	DEBUG("############################################################" << std::endl)
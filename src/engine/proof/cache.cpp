@@ -0,0 +1,328 @@
+#include "engine/proof.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+#include "logics/serialize.hpp"
+#include "logics/util.hpp"
+#include "util/shortcuts.hpp"
+
+using namespace plankton;
+
+
+//
+// Key
+//
+
+static constexpr std::string_view CACHE_HEADER = "plankton-proof-cache";
+static constexpr std::size_t CACHE_VERSION = 4;
+
+inline void DescribeConfig(std::ostream& stream, const SolverConfig& config, const Program& program) {
+    // instantiate everything the engine may query, symbol names are made canonical afterwards, see 'CanonicalizeSymbols'
+    SymbolFactory factory;
+    auto& flowType = config.GetFlowValueType();
+    stream << "flow " << flowType.name << std::endl;
+    for (const auto& type : program.types) {
+        stream << "type " << type->name << std::endl;
+        for (const auto& [field, fieldType] : type->fields) {
+            stream << "field " << field << " " << fieldType.get().name << " " << config.GetMaxFootprintDepth(*type, field) << std::endl;
+        }
+        auto shared = plankton::MakeSharedMemory(factory.GetFreshFO(*type), flowType, factory);
+        auto local = plankton::MakeLocalMemory(factory.GetFreshFO(*type), flowType, factory);
+        auto& value = factory.GetFreshFO(flowType);
+        stream << *config.GetSharedNodeInvariant(*shared) << std::endl;
+        stream << *config.GetLocalNodeInvariant(*local) << std::endl;
+        stream << *config.GetLogicallyContains(*shared, value) << std::endl;
+        for (const auto& [field, fieldType] : type->fields) {
+            if (fieldType.get().sort != Sort::PTR) continue;
+            stream << *config.GetOutflowContains(*shared, field, value) << std::endl;
+        }
+    }
+    for (const auto& variable : program.variables) {
+        stream << "variable " << variable->name << " " << variable->type.name << std::endl;
+        EqualsToAxiom resource(*variable, factory.GetFreshFO(variable->type));
+        stream << *config.GetSharedVariableInvariant(resource) << std::endl;
+    }
+}
+
+inline std::string CanonicalizeSymbols(const std::string& description) {
+    // symbol names stem from a global counter, they depend on the symbols created so far; number them by occurrence instead
+    static const std::regex symbolName("@[a-zA-Z][0-9]+");
+    std::map<std::string, std::size_t> numbering;
+    std::string result;
+    auto position = description.cbegin();
+    for (auto it = std::sregex_iterator(description.begin(), description.end(), symbolName); it != std::sregex_iterator(); ++it) {
+        auto name = it->str();
+        auto number = numbering.emplace(name, numbering.size()).first->second;
+        result.append(position, description.cbegin() + it->position());
+        result += name.substr(0, 2) + std::to_string(number);
+        position = description.cbegin() + it->position() + it->length();
+    }
+    result.append(position, description.cend());
+    return result;
+}
+
+inline void DescribeSetup(std::ostream& stream, const EngineSetup& setup) {
+    // options that do not influence the outcome, like the number of jobs, are left out
+    stream << setup.loopJoinUntilFixpoint << setup.loopJoinPost << " " << setup.loopMaxIterations << " ";
+    stream << setup.macrosTabulateInvocations << std::endl;
+}
+
+inline std::string HashToString(const std::string& description) {
+    // FNV-1a, unlike std::hash its result is stable across runs and platforms
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto chr : description) {
+        hash ^= static_cast<unsigned char>(chr);
+        hash *= 1099511628211ULL;
+    }
+    std::stringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return stream.str();
+}
+
+inline void DescribeMacro(std::ostream& stream, const Function& function) {
+    // a macro post depends on the bodies of all macros the function calls, directly or indirectly
+    struct : public ProgramListener {
+        std::deque<const Function*> callees;
+        void Enter(const Macro& object) override { callees.push_back(&object.Func()); }
+    } collector;
+    std::set<const Function*> described;
+    collector.callees.push_back(&function);
+    while (!collector.callees.empty()) {
+        const auto* next = collector.callees.front();
+        collector.callees.pop_front();
+        if (!described.insert(next).second) continue;
+        stream << *next << std::endl;
+        next->Accept(collector);
+    }
+}
+
+std::string ProofGenerator::MakeProofCacheKey() const {
+    std::stringstream program, config, setup;
+    for (const auto& type : this->program.types) program << *type << std::endl;
+    program << this->program;
+    DescribeConfig(config, this->config, this->program);
+    DescribeSetup(setup, this->setup);
+    return HashToString(program.str()) + "-" + HashToString(CanonicalizeSymbols(config.str())) + "-" + HashToString(setup.str());
+}
+
+std::string ProofGenerator::MakeMacroCacheKey(const Function& function) const {
+    // time predicates are improved inside macros, so their posts depend on the suggested futures as well
+    std::stringstream description;
+    DescribeMacro(description, function);
+    for (const auto& suggestion : *futureSuggestions) description << *suggestion << std::endl;
+    return HashToString(CanonicalizeSymbols(description.str()));
+}
+
+inline std::string_view ProgramPartOfKey(std::string_view key) {
+    return key.substr(0, key.find('-'));
+}
+
+inline std::string_view ConfigPartOfKey(std::string_view key) {
+    auto separator = key.find('-');
+    return separator == std::string_view::npos ? std::string_view() : key.substr(separator + 1);
+}
+
+
+//
+// Loading
+//
+
+inline void Expect(std::istream& stream, const std::string& expected) {
+    std::string token;
+    stream >> token;
+    if (token == expected) return;
+    throw std::logic_error("Malformed proof cache: expected '" + expected + "'."); // TODO: better error handling
+}
+
+inline std::size_t ReadCount(std::istream& stream) {
+    std::size_t result;
+    if (stream >> result) return result;
+    throw std::logic_error("Malformed proof cache: expected number."); // TODO: better error handling
+}
+
+inline std::string ReadName(std::istream& stream) {
+    std::string result;
+    if (stream >> result) return result;
+    throw std::logic_error("Malformed proof cache: expected name."); // TODO: better error handling
+}
+
+template<typename T>
+inline const T* TryFindByName(const std::vector<std::unique_ptr<T>>& container, const std::string& name) {
+    for (const auto& elem : container) {
+        if (elem->name == name) return elem.get();
+    }
+    return nullptr;
+}
+
+template<typename T>
+inline const T& FindByName(const std::vector<std::unique_ptr<T>>& container, const std::string& name) {
+    if (auto result = TryFindByName(container, name)) return *result;
+    throw std::logic_error("Malformed proof cache: unknown name '" + name + "'."); // TODO: better error handling
+}
+
+inline std::string ReadBlock(std::istream& stream, std::size_t length) {
+    if (stream.get() != '\n') throw std::logic_error("Malformed proof cache: expected line break."); // TODO: better error handling
+    std::string result(length, '\0');
+    if (stream.read(result.data(), static_cast<std::streamsize>(length))) return result;
+    throw std::logic_error("Malformed proof cache: truncated macro table."); // TODO: better error handling
+}
+
+void ProofGenerator::LoadProofCache() {
+    if (setup.proofCachePath.empty()) return;
+    std::ifstream stream(setup.proofCachePath);
+    if (!stream.good()) {
+        INFO(infoPrefix << "No proof cache found." << std::endl)
+        return;
+    }
+
+    // read everything before altering the proof state, a broken cache must not leave a partial state behind
+    std::deque<std::unique_ptr<HeapEffect>> effects;
+    std::map<const Function*, std::deque<MacroPost>> tables;
+    std::size_t outdated = 0;
+    try {
+        Expect(stream, std::string(CACHE_HEADER));
+        Expect(stream, std::to_string(CACHE_VERSION));
+        auto key = ReadName(stream);
+        auto expected = MakeProofCacheKey();
+        if (ConfigPartOfKey(key) != ConfigPartOfKey(expected)) {
+            INFO(infoPrefix << "Proof cache is outdated." << std::endl)
+            return;
+        }
+        auto sameProgram = ProgramPartOfKey(key) == ProgramPartOfKey(expected);
+        if (!sameProgram) {
+            INFO(infoPrefix << "Proof cache stems from a different version of the program, reusing its interference only." << std::endl)
+        }
+        LogicReader reader(stream, program);
+        Expect(stream, "interference");
+        for (auto count = ReadCount(stream); count > 0; --count) effects.push_back(plankton::DeserializeHeapEffect(reader));
+        Expect(stream, "macros");
+        // footprints cannot tell which posts effects of the changed program affect, so only the interference is reused
+        for (auto functions = sameProgram ? ReadCount(stream) : 0; functions > 0; --functions) {
+            auto name = ReadName(stream);
+            auto macroKey = ReadName(stream);
+            auto entries = ReadCount(stream);
+            auto block = ReadBlock(stream, ReadCount(stream));
+            auto function = TryFindByName(program.macroFunctions, name);
+            if (!function || macroKey != MakeMacroCacheKey(*function)) {
+                ++outdated;
+                continue;
+            }
+            std::istringstream blockStream(block);
+            LogicReader blockReader(blockStream, program);
+            auto& table = tables[function];
+            for (; entries > 0; --entries) {
+                auto posts = ReadCount(blockStream);
+                Footprint footprint;
+                for (auto fields = ReadCount(blockStream); fields > 0; --fields) {
+                    auto field = ReadName(blockStream);
+                    auto separator = field.find(':');
+                    if (separator == std::string::npos) throw std::logic_error("Malformed proof cache: expected field."); // TODO: better error handling
+                    footprint.emplace(&FindByName(program.types, field.substr(0, separator)), field.substr(separator + 1));
+                }
+                auto pre = plankton::Normalize(blockReader.Read<Annotation>());
+                AnnotationList post;
+                for (; posts > 0; --posts) post.push_back(blockReader.Read<Annotation>());
+                table.emplace_back(std::move(pre), std::move(post), std::move(footprint));
+            }
+        }
+    } catch (std::logic_error& err) {
+        WARNING("ignoring proof cache '" << setup.proofCachePath << "': " << err.what() << std::endl)
+        return;
+    }
+
+    // the cached interference is sound to seed even for a changed program, see 'LoadInterferenceSeed';
+    // macro posts are only valid for the cached interference, so they must not be invalidated by it
+    INFO(infoPrefix << "Seeding interference set from proof cache (" << effects.size() << ")." << std::endl)
+    newInterference = std::move(effects);
+    ConsolidateNewInterference();
+    if (outdated > 0) INFO(infoPrefix << "Discarding cached posts of changed macros (" << outdated << ")." << std::endl)
+    if (!setup.macrosTabulateInvocations) return;
+    for (auto& [function, entries] : tables) {
+        for (auto& entry : entries) macroPostTable[function].Add(std::move(entry));
+    }
+}
+
+
+//
+// Storing
+//
+
+void ProofGenerator::StoreProofCache() const {
+    if (setup.proofCachePath.empty()) return;
+
+    // write to a temporary file first, concurrent or aborted runs must not leave a truncated cache behind
+    auto temporary = setup.proofCachePath + ".tmp";
+    {
+        std::ofstream stream(temporary);
+        if (!stream.good()) {
+            WARNING("could not write proof cache '" << setup.proofCachePath << "'." << std::endl)
+            return;
+        }
+        stream << CACHE_HEADER << " " << CACHE_VERSION << " " << MakeProofCacheKey() << std::endl;
+        LogicWriter writer(stream, program);
+        const auto& interference = solver.GetInterference();
+        stream << "interference " << interference.size() << std::endl;
+        for (const auto& effect : interference) plankton::Serialize(writer, *effect);
+        stream << "macros " << macroPostTable.size() << std::endl;
+        for (const auto& [function, table] : macroPostTable) {
+            // every table is a block of its own, so that tables of changed macros can be skipped when loading
+            std::stringstream block;
+            {
+                LogicWriter blockWriter(block, program);
+                for (const auto& entry : table.entries) {
+                    block << entry.post.size() << " " << entry.footprint.size();
+                    for (const auto& [type, field] : entry.footprint) block << " " << type->name << ":" << field; // "" for the flow
+                    block << std::endl;
+                    blockWriter.Write(*entry.pre);
+                    for (const auto& post : entry.post) blockWriter.Write(*post);
+                }
+            }
+            auto content = block.str();
+            stream << function->name << " " << MakeMacroCacheKey(*function) << " " << table.entries.size() << " ";
+            stream << content.size() << std::endl << content;
+        }
+        if (!stream.good()) {
+            WARNING("could not write proof cache '" << setup.proofCachePath << "'." << std::endl)
+            return;
+        }
+    }
+    if (std::rename(temporary.c_str(), setup.proofCachePath.c_str()) != 0) {
+        WARNING("could not write proof cache '" << setup.proofCachePath << "'." << std::endl)
+        return;
+    }
+    INFO(infoPrefix << "Stored proof in cache '" << setup.proofCachePath << "'." << std::endl)
+}
+
+
+//
+// Seeding
+//
+
+void ProofGenerator::LoadInterferenceSeed() {
+    if (setup.interferenceSeedPath.empty()) return;
+    std::ifstream stream(setup.interferenceSeedPath);
+    if (!stream.good()) {
+        throw std::logic_error("Could not read interference seed '" + setup.interferenceSeedPath + "'."); // TODO: better error handling
+    }
+
+    // seeded effects need not stem from this program, the fixed-point iteration still has to confirm them stable
+    LogicReader reader(stream, program);
+    std::deque<std::unique_ptr<HeapEffect>> effects;
+    while (!reader.AtEnd()) effects.push_back(plankton::DeserializeHeapEffect(reader));
+    INFO(infoPrefix << "Seeding interference set from '" << setup.interferenceSeedPath << "' (" << effects.size() << ")." << std::endl)
+    plankton::MoveInto(std::move(effects), newInterference);
+    ConsolidateNewInterference();
+}
+
+void ProofGenerator::StoreInterference() const {
+    if (setup.interferenceOutputPath.empty()) return;
+    std::ofstream stream(setup.interferenceOutputPath);
+    LogicWriter writer(stream, program);
+    for (const auto& effect : solver.GetInterference()) plankton::Serialize(writer, *effect);
+    if (!stream.good()) {
+        throw std::logic_error("Could not write interference to '" + setup.interferenceOutputPath + "'."); // TODO: better error handling
+    }
+}
@@ -1,6 +1,8 @@
 #include "engine/proof.hpp"
 
 #include "programs/util.hpp"
+#include "logics/util.hpp"
+#include "engine/util.hpp"
 #include "util/shortcuts.hpp"
 #include "util/log.hpp"
 
@@ -8,11 +10,25 @@ using namespace plankton;
 
 
 ProofGenerator::ProofGenerator(const Program& program, const SolverConfig& config, EngineSetup setup)
-        : program(program), solver(program, config), setup(setup), insideAtomic(false),
+        : program(program), config(config), solver(program, config), setup(setup), insideAtomic(false),
           timePost("TIME Post"), timeJoin("TIME Join"), timeInterference("TIME Interference"),
           timePastImprove("TIME Past improve"), timePastReduce("TIME Past reduce"),
           timeFutureImprove("TIME Future improve"), timeFutureReduce("TIME Future reduce") {
-    futureSuggestions = plankton::SuggestFutures(program);
+    futureSuggestions = std::make_shared<std::deque<std::unique_ptr<FutureSuggestion>>>(plankton::SuggestFutures(program));
+}
+
+ProofGenerator::ProofGenerator(const ProofGenerator& parent)
+        : program(parent.program), config(parent.config), solver(parent.solver), setup(parent.setup), insideAtomic(false),
+          futureSuggestions(parent.futureSuggestions), infoPrefix(parent.infoPrefix),
+          timePost("TIME Post", false), timeJoin("TIME Join", false), timeInterference("TIME Interference", false),
+          timePastImprove("TIME Past improve", false), timePastReduce("TIME Past reduce", false),
+          timeFutureImprove("TIME Future improve", false), timeFutureReduce("TIME Future reduce", false) {
+    for (const auto& [function, table] : parent.macroPostTable) {
+        auto& copy = macroPostTable[function];
+        for (const auto& entry : table.entries) {
+            copy.Add(MacroPost(plankton::Copy(*entry.pre), plankton::CopyAll(entry.post), entry.footprint));
+        }
+    }
 }
 
 void ProofGenerator::LeaveAllNestedScopes(const AstNode& node) {
@@ -29,23 +45,45 @@ void ProofGenerator::LeaveAllNestedScopes(const AstNode& node) {
     }
 }
 
-void ProofGenerator::PruneCurrent() {
-    // TODO: keep or remove?
-
-    for (auto& annotation : current) {
+template<typename T, typename G, typename F>
+inline void PruneImplied(const Solver& solver, std::deque<T>& container, const G& getAnnotation, const F& isComparable) {
+    for (auto& elem : container) {
+        auto& annotation = getAnnotation(elem);
         if (!solver.IsUnsatisfiable(*annotation)) continue;
         annotation.reset(nullptr);
     }
-    for (const auto& annotation : current) {
+
+    // only annotations with the same variable resources may imply each other, see AnnotationSignature::MayImply
+    std::deque<std::unique_ptr<AnnotationSignature>> signatures;
+    std::map<std::set<const VariableDeclaration*>, std::vector<std::size_t>> buckets;
+    for (std::size_t index = 0; index < container.size(); ++index) {
+        auto& annotation = getAnnotation(container.at(index));
+        signatures.push_back(annotation ? std::make_unique<AnnotationSignature>(*annotation) : nullptr);
+        if (annotation) buckets[signatures.back()->variables].push_back(index);
+    }
+
+    // same order of checks as the all-pairs loop, pairs across buckets are skipped
+    for (std::size_t index = 0; index < container.size(); ++index) {
+        const auto& annotation = getAnnotation(container.at(index));
         if (!annotation) continue;
-        for (auto& otherAnnotation : current) {
+        for (auto other : buckets.at(signatures.at(index)->variables)) {
+            auto& otherAnnotation = getAnnotation(container.at(other));
             if (!otherAnnotation) continue;
-            if (annotation.get() == otherAnnotation.get()) continue;
+            if (index == other) continue;
+            if (!isComparable(container.at(index), container.at(other))) continue;
+            if (!signatures.at(other)->MayImply(*signatures.at(index))) continue;
             if (!solver.Implies(*otherAnnotation, *annotation)) continue;
             otherAnnotation.reset(nullptr);
         }
     }
-    plankton::RemoveIf(current, [](const auto& elem) { return !elem; });
+    plankton::RemoveIf(container, [&getAnnotation](auto& elem) { return !getAnnotation(elem); });
+}
+
+void ProofGenerator::PruneCurrent() {
+    // TODO: keep or remove?
+    PruneImplied(solver, current,
+                 [](auto& elem) -> std::unique_ptr<Annotation>& { return elem; },
+                 [](const auto&, const auto&) { return true; });
 }
 
 inline bool SameReturns(const Return* command, const Return* other) {
@@ -60,23 +98,9 @@ inline bool SameReturns(const Return* command, const Return* other) {
 
 void ProofGenerator::PruneReturning() {
     // TODO: keep or remove?
-
-    // TODO: avoid code duplication
-    for (auto& pair : returning) {
-        if (!solver.IsUnsatisfiable(*pair.first)) continue;
-        pair.first.reset(nullptr);
-    }
-    for (const auto& [annotation, command] : returning) {
-        if (!annotation) continue;
-        for (auto& [otherAnnotation, otherCommand] : returning) {
-            if (!otherAnnotation) continue;
-            if (annotation.get() == otherAnnotation.get()) continue;
-            if (!SameReturns(command, otherCommand)) continue;
-            if (!solver.Implies(*otherAnnotation, *annotation)) continue;
-            otherAnnotation.reset(nullptr);
-        }
-    }
-    plankton::RemoveIf(returning, [](const auto& elem) { return !elem.first; });
+    PruneImplied(solver, returning,
+                 [](auto& elem) -> std::unique_ptr<Annotation>& { return elem.first; },
+                 [](const auto& elem, const auto& other) { return SameReturns(elem.second, other.second); });
 }
 
 void ProofGenerator::ApplyTransformer(const std::function<std::unique_ptr<Annotation>(std::unique_ptr<Annotation>)>& transformer) {
@@ -103,11 +127,46 @@ void ProofGenerator::AddNewInterference(std::deque<std::unique_ptr<HeapEffect>>
 
 bool ProofGenerator::ConsolidateNewInterference() {
     INFO(infoPrefix << "Checking for new effects. (" << newInterference.size() << ") " << std::endl)
+
+    // tabulated macro posts that may be affected by the new effects, effects removed from the interference
+    // are subsumed by added ones (and thus share their node type and updated fields)
+    std::set<const MacroPost*> affected;
+    std::size_t tabulated = 0;
+    for (const auto& [function, table] : macroPostTable) {
+        tabulated += table.entries.size();
+        for (const auto& entry : table.entries) {
+            if (!plankton::Any(newInterference, [&entry](const auto& effect) {
+                return plankton::IsAffected(entry.footprint, *effect);
+            })) continue;
+            affected.insert(&entry);
+        }
+    }
+
     auto result = solver.AddInterference(std::move(newInterference));
     newInterference.clear();
+    if (!result) return result;
+
+    for (auto& [function, table] : macroPostTable) {
+        table.RemoveIf([&affected](const auto& entry) { return plankton::Membership(affected, &entry); });
+    }
+    DEBUG("Invalidated " << affected.size() << " tabulated macro posts." << std::endl)
+    auto& profiler = Profiler::Instance();
+    if (profiler.IsEnabled()) {
+        profiler.Record("Macro posts kept", tabulated - affected.size(), "posts");
+        profiler.Record("Macro posts invalidated", affected.size(), "posts");
+    }
     return result;
 }
 
+void ProofGenerator::AddToMacroFootprints(const Footprint& footprint) {
+    for (auto& elem : macroFootprints) plankton::InsertInto(footprint, elem);
+}
+
+EffectFootprint* ProofGenerator::MacroFootprint() {
+    // enclosing derivations receive the footprint once the innermost one completes, see 'HandleMacroLazy'
+    return macroFootprints.empty() ? nullptr : &macroFootprints.back();
+}
+
 void ProofGenerator::MakeInterferenceStable(const Statement& after) {
     INFO(infoPrefix << "Applying interference." << INFO_SIZE << std::endl)
     if (insideAtomic) return;
@@ -117,11 +176,11 @@ void ProofGenerator::MakeInterferenceStable(const Statement& after) {
         // TODO: improve future?
         {
             auto measure = timePastImprove.Measure();
-            annotation = solver.ImprovePast(std::move(annotation));
+            annotation = solver.ImprovePast(std::move(annotation), MacroFootprint());
         }
         {
             auto measure = timeInterference.Measure();
-            annotation = solver.MakeInterferenceStable(std::move(annotation));
+            annotation = solver.MakeInterferenceStable(std::move(annotation), MacroFootprint());
         }
         {
             auto measure = timePastReduce.Measure();
@@ -153,21 +212,21 @@ void ProofGenerator::ImproveCurrentTime() {
     INFO(infoPrefix << "Improving time predicates." << INFO_SIZE << std::endl)
     ApplyTransformer([this](auto annotation) {
         auto measure = timePastImprove.Measure();
-        return solver.ImprovePast(std::move(annotation));
+        return solver.ImprovePast(std::move(annotation), MacroFootprint());
     });
-    for (const auto& future : futureSuggestions) {
+    for (const auto& future : *futureSuggestions) {
         ApplyTransformer([this, &future](auto annotation) {
             auto measure = timeFutureImprove.Measure();
-            return solver.ImproveFuture(std::move(annotation), *future);
+            return solver.ImproveFuture(std::move(annotation), *future, MacroFootprint());
         });
     }
-    for (const auto& future : futureSuggestions) { // repeat because Z3 hates us...
+    for (const auto& future : *futureSuggestions) { // repeat because Z3 hates us...
         ApplyTransformer([this, &future](auto annotation) {
             auto measure = timeFutureImprove.Measure();
-            return solver.ImproveFuture(std::move(annotation), *future);
+            return solver.ImproveFuture(std::move(annotation), *future, MacroFootprint());
         });
     }
-    //for (const auto& future : futureSuggestions) { // repeat because Z3 really hates us... why?
+    //for (const auto& future : *futureSuggestions) { // repeat because Z3 really hates us... why?
     //    ApplyTransformer([this, &future](auto annotation) {
     //        auto measure = timeFutureImprove.Measure();
     //        return solver.ImproveFuture(std::move(annotation), *future);
@@ -140,24 +140,66 @@ inline void CleanAnnotation(Annotation& annotation) {
     plankton::RemoveIf(annotation.past, containsPruned);
 }
 
+ProofGenerator::MacroPost::MacroPost(std::unique_ptr<Annotation> pre_, AnnotationList post_, Footprint footprint_)
+        : pre(std::move(pre_)), post(std::move(post_)), footprint(std::move(footprint_)), signature(*pre),
+          key(plankton::SyntacticalHash(*pre)) {
+}
+
+void ProofGenerator::MacroTabulation::Add(MacroPost entry) {
+    exact.emplace(entry.key, entries.size());
+    entries.push_back(std::move(entry));
+}
+
+bool ProofGenerator::MacroTabulation::Contains(const MacroPost& entry) const {
+    auto [begin, end] = exact.equal_range(entry.key);
+    for (auto it = begin; it != end; ++it) {
+        if (plankton::SyntacticalEqual(*entries.at(it->second).pre, *entry.pre)) return true;
+    }
+    return false;
+}
+
+void ProofGenerator::MacroTabulation::RemoveIf(const std::function<bool(const MacroPost&)>& unaryPredicate) {
+    plankton::RemoveIf(entries, unaryPredicate);
+    exact.clear();
+    for (std::size_t index = 0; index < entries.size(); ++index) exact.emplace(entries.at(index).key, index);
+}
+
 inline std::optional<ProofGenerator::AnnotationList>
 ProofGenerator::LookupMacroPost(const Macro& macro, const Annotation& annotation) {
     auto find = macroPostTable.find(&macro.Func());
-    if (find != macroPostTable.end()) {
-        for (const auto&[pre, post]: find->second) {
-            if (!solver.Implies(annotation, *pre)) continue;
-            return plankton::CopyAll(post);
-        }
+    if (find == macroPostTable.end()) return std::nullopt;
+    const auto& table = find->second;
+    auto hit = [this](const MacroPost& entry) {
+        AddToMacroFootprints(entry.footprint); // reusing 'post' makes enclosing derivations depend on its footprint
+        return plankton::CopyAll(entry.post);
+    };
+
+    // exact hit
+    auto normalized = plankton::Normalize(plankton::Copy(annotation));
+    auto [begin, end] = table.exact.equal_range(plankton::SyntacticalHash(*normalized));
+    for (auto it = begin; it != end; ++it) {
+        const auto& entry = table.entries.at(it->second);
+        if (plankton::SyntacticalEqual(*normalized, *entry.pre)) return hit(entry);
+    }
+
+    // semantic hit, skip entries that cannot be implied
+    AnnotationSignature signature(annotation);
+    for (const auto& entry : table.entries) {
+        if (!signature.MayImply(entry.signature)) continue;
+        if (!solver.Implies(annotation, *entry.pre)) continue;
+        return hit(entry);
     }
     return std::nullopt;
 }
 
 inline void
-ProofGenerator::AddMacroPost(const Macro& macro, const Annotation& pre, const ProofGenerator::AnnotationList& post) {
+ProofGenerator::AddMacroPost(const Macro& macro, const Annotation& pre, const ProofGenerator::AnnotationList& post,
+                             const Footprint& footprint) {
     // DEBUG("%% storing macro post: " << pre << " >>>>> ")
     // for (const auto& elem : post) DEBUG(*elem)
     // DEBUG(std::endl)
-    macroPostTable[&macro.Func()].emplace_back(plankton::Copy(pre), plankton::CopyAll(post));
+    auto normalized = plankton::Normalize(plankton::Copy(pre));
+    macroPostTable[&macro.Func()].Add(MacroPost(std::move(normalized), plankton::CopyAll(post), footprint));
 }
 
 void ProofGenerator::HandleMacroLazy(const Macro& cmd) {
@@ -178,10 +220,14 @@ void ProofGenerator::HandleMacroLazy(const Macro& cmd) {
     if (!current.empty()) {
         for (auto& elem : current) CleanAnnotation(*elem);
         auto pre = plankton::CopyAll(current);
+        macroFootprints.emplace_back();
         cmd.Func().Accept(*this);
         HandleMacroEpilog(cmd);
+        auto footprint = std::move(macroFootprints.back());
+        macroFootprints.pop_back();
+        AddToMacroFootprints(footprint);
         // for (auto& elem : current) CleanAnnotation(*elem);
-        for (const auto& elem : pre) AddMacroPost(cmd, *elem, current);
+        for (const auto& elem : pre) AddMacroPost(cmd, *elem, current, footprint);
     }
 
     plankton::MoveInto(std::move(post), current);
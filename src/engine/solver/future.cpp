@@ -75,18 +75,7 @@ inline void FilterEffects(std::deque<std::unique_ptr<HeapEffect>>& effects) {
         plankton::RenameSymbols(*effect->context, renaming);
     }
 
-    for (auto it = effects.begin(); it != effects.end(); ++it) {
-        if (!*it) continue;
-        for (auto ot = std::next(it); ot != effects.end(); ++ot) {
-            if (!*ot) continue;
-            if (!plankton::SyntacticalEqual(*(**it).pre, *(**ot).pre)) continue;
-            if (!plankton::SyntacticalEqual(*(**it).post, *(**ot).post)) continue;
-            if (!plankton::SyntacticalEqual(*(**it).context, *(**ot).context)) continue;
-            ot->reset(nullptr);
-        }
-    }
-
-    plankton::RemoveIf(effects, [](const auto& elem){ return !elem; });
+    plankton::RemoveDuplicateEffects(effects);
 }
 
 void Solver::ReduceFuture(Annotation& annotation) const {
@@ -173,7 +162,7 @@ inline bool TargetUpdateIsCovered(const FutureInfo& info) {
         }
         checks.push_back(encoding.MakeAnd(equalities));
     }
-    return encoding.Implies(encoding.MakeOr(checks));
+    return encoding.Implies(encoding.MakeOr(checks), CheckMode::OPTIONAL);
 
     // return plankton::Any(info.matchingFutures, [&info,&encoding](const auto* future) {
     //     for (std::size_t index = 0 ; index < future->update->values.size() ; ++index) {
@@ -279,7 +268,7 @@ inline void AddTrivialFuture(Annotation& annotation, const FutureSuggestion& tar
     if (!guard) return; // variables from target are out of scope
     auto symbols = plankton::Collect<SymbolDeclaration>(*guard);
     Encoding encoding(*guard);
-    bool unsat = encoding.ImpliesFalse();
+    bool unsat = encoding.ImpliesFalse(CheckMode::OPTIONAL);
     auto getAlias = [&symbols,&encoding,unsat](const auto& expr) -> const SymbolDeclaration* {
         if (unsat) return nullptr;
         auto variable = dynamic_cast<const SymbolicVariable*>(&expr);
@@ -292,7 +281,7 @@ inline void AddTrivialFuture(Annotation& annotation, const FutureSuggestion& tar
             if (*symbol == decl) continue;
             if (symbol->type != decl.type) continue;
             auto symbolEnc = encoding.Encode(*symbol);
-            if (encoding.Implies(declEnc == symbolEnc)) return symbol;
+            if (encoding.Implies(declEnc == symbolEnc, CheckMode::OPTIONAL)) return symbol;
         }
         return nullptr;
     };
@@ -359,12 +348,13 @@ inline std::unique_ptr<Annotation> MakePostState(FutureInfo& info, const FutureP
     return result;
 }
 
-PostImage Solver::ImproveFuture(std::unique_ptr<Annotation> pre, const FutureSuggestion& target) const {
+PostImage Solver::ImproveFuture(std::unique_ptr<Annotation> pre, const FutureSuggestion& target, EffectFootprint* footprint) const {
     MEASURE("Solver::ImproveFuture")
     DEBUG("<<IMPROVE FUTURE>>" << std::endl)
     assert(target.command);
     assert(pre);
 
+    if (footprint) plankton::AddToFootprint(*pre, *footprint); // immutability relies on the interference for its memory
     PostImage result(std::move(pre));
     auto& annotation = *result.annotations.front();
     AddTrivialFuture(annotation, target);
@@ -1,5 +1,9 @@
 #include "engine/solver.hpp"
 
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #include "logics/util.hpp"
 #include "engine/encoding.hpp"
 #include "engine/util.hpp"
@@ -22,36 +26,30 @@ inline bool QuickMismatchCheck(const Annotation& premise, const Annotation& conc
            != plankton::Collect<EqualsToAxiom>(*conclusion.now).size();
 }
 
+template<typename T>
+inline bool AllIncluded(const T& premise, const T& conclusion) {
+    if (conclusion.empty()) return true;
+    std::unordered_multimap<std::size_t, const LogicObject*> lookup;
+    for (const auto& elem : premise) lookup.emplace(plankton::SyntacticalHash(*elem), elem.get());
+    return plankton::All(conclusion, [&lookup](const auto& elem) {
+        auto [begin, end] = lookup.equal_range(plankton::SyntacticalHash(*elem));
+        return std::any_of(begin, end, [&elem](const auto& pair) {
+            return plankton::SyntacticalEqual(*elem, *pair.second);
+        });
+    });
+}
+
 inline bool NowSyntacticallyIncluded(const SeparatingConjunction& premise, const SeparatingConjunction& conclusion) {
     assert(plankton::Collect<EqualsToAxiom>(premise).size() == plankton::Collect<EqualsToAxiom>(conclusion).size());
-    std::set<const Formula*> missing;
-    for (const auto& conjunct : conclusion.conjuncts) {
-        auto subsumed = plankton::Any(premise.conjuncts, [&conjunct](const auto& other){
-            return plankton::SyntacticalEqual(*conjunct, *other);
-        });
-        if (!subsumed) return false;
-    }
-    return true;
+    return AllIncluded(premise.conjuncts, conclusion.conjuncts);
 }
 
 inline bool PastSyntacticallyIncluded(const Annotation& premise, const Annotation& conclusion) {
-    for (const auto& past : conclusion.past) {
-        auto subsumed = plankton::Any(premise.past, [&past](const auto& other){
-            return plankton::SyntacticalEqual(*past, *other);
-        });
-        if (!subsumed) return false;
-    }
-    return true;
+    return AllIncluded(premise.past, conclusion.past);
 }
 
 inline bool FutureSyntacticallyIncluded(const Annotation& premise, const Annotation& conclusion) {
-    for (const auto& future : conclusion.future) {
-        auto subsumed = plankton::Any(premise.future, [&future](const auto& other) {
-            return plankton::SyntacticalEqual(*future, *other);
-        });
-        if (!subsumed) return false;
-    }
-    return true;
+    return AllIncluded(premise.future, conclusion.future);
 }
 
 inline bool SyntacticallyIncluded(const Annotation& premise, const Annotation& conclusion) {
@@ -76,7 +74,7 @@ struct AxiomAnalyser : public DefaultLogicVisitor {
 };
 
 inline bool IsStack(const std::unique_ptr<Formula>& object) {
-    static AxiomAnalyser analyser;
+    AxiomAnalyser analyser;
     return analyser.IsStack(*object);
 }
 
@@ -115,13 +113,82 @@ inline void TryAvoidHistoryMismatch(Annotation& premise, Annotation& conclusion)
     });
 }
 
-bool Solver::Implies(const Annotation& premise, const Annotation& conclusion) const {
-    MEASURE("Solver::Implies")
-    if (QuickMismatchCheck(premise, conclusion)) return false;
-    // DEBUG("== CHK IMP " << premise << " ==> " << conclusion << std::endl)
+static constexpr std::size_t IMPLICATION_CACHE_CAPACITY = 4096;
+
+struct ImplicationCache {
+    struct Entry {
+        std::size_t key;
+        std::size_t config; // id, addresses may be reused
+        std::unique_ptr<Annotation> premise;
+        std::unique_ptr<Annotation> conclusion;
+        bool result;
+    };
+
+    std::mutex mutex;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_multimap<std::size_t, std::list<Entry>::iterator> lookup;
+    ImplicationCacheStatistics statistics;
+
+    static std::size_t MakeKey(const Annotation& premise, const Annotation& conclusion) {
+        auto result = plankton::SyntacticalHash(premise);
+        return result ^ (plankton::SyntacticalHash(conclusion) + 0x9e3779b9 + (result << 6) + (result >> 2));
+    }
 
-    auto normalizedPremise = plankton::Normalize(plankton::Copy(premise));
-    auto normalizedConclusion = plankton::Normalize(plankton::Copy(conclusion));
+    std::optional<bool> Get(std::size_t key, const SolverConfig& config, const Annotation& premise, const Annotation& conclusion) {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto [begin, end] = lookup.equal_range(key);
+        for (auto it = begin; it != end; ++it) {
+            auto& entry = *it->second;
+            if (entry.config != config.id) continue;
+            if (!plankton::SyntacticalEqual(*entry.premise, premise)) continue;
+            if (!plankton::SyntacticalEqual(*entry.conclusion, conclusion)) continue;
+            entries.splice(entries.begin(), entries, it->second);
+            ++statistics.hits;
+            return entry.result;
+        }
+        ++statistics.misses;
+        return std::nullopt;
+    }
+
+    void Put(std::size_t key, const SolverConfig& config, std::unique_ptr<Annotation> premise,
+             std::unique_ptr<Annotation> conclusion, bool result) {
+        std::lock_guard<std::mutex> guard(mutex);
+        entries.push_front({ key, config.id, std::move(premise), std::move(conclusion), result });
+        lookup.emplace(key, entries.begin());
+        if (entries.size() <= IMPLICATION_CACHE_CAPACITY) return;
+        auto last = std::prev(entries.end());
+        auto [begin, end] = lookup.equal_range(last->key);
+        for (auto it = begin; it != end; ++it) {
+            if (it->second != last) continue;
+            lookup.erase(it);
+            break;
+        }
+        entries.pop_back();
+    }
+};
+
+inline ImplicationCache& GetImplicationCache() {
+    static ImplicationCache cache;
+    return cache;
+}
+
+ImplicationCacheStatistics plankton::GetImplicationCacheStatistics() {
+    auto& cache = GetImplicationCache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    auto result = cache.statistics;
+    result.size = cache.entries.size();
+    return result;
+}
+
+void plankton::ClearImplicationCache() {
+    auto& cache = GetImplicationCache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    cache.lookup.clear();
+    cache.entries.clear();
+}
+
+inline bool ComputeImplies(std::unique_ptr<Annotation> normalizedPremise, std::unique_ptr<Annotation> normalizedConclusion,
+                           const SolverConfig& config) {
     TryAvoidHistoryMismatch(*normalizedPremise, *normalizedConclusion);
     if (SyntacticallyIncluded(*normalizedPremise, *normalizedConclusion)) return true;
     // DEBUG("== CHK IMP deep " << *normalizedPremise << " ==> " << *normalizedConclusion << std::endl)
@@ -136,3 +203,22 @@ bool Solver::Implies(const Annotation& premise, const Annotation& conclusion) co
     return ResourcesMatch(*normalizedPremise, *normalizedConclusion) &&
            StackImplies(*normalizedPremise, *normalizedConclusion->now, config);
 }
+
+bool Solver::Implies(const Annotation& premise, const Annotation& conclusion) const {
+    MEASURE("Solver::Implies")
+    if (QuickMismatchCheck(premise, conclusion)) return false;
+    // DEBUG("== CHK IMP " << premise << " ==> " << conclusion << std::endl)
+
+    // normalization renames symbols canonically, so alpha-equivalent queries share cache entries
+    auto normalizedPremise = plankton::Normalize(plankton::Copy(premise));
+    auto normalizedConclusion = plankton::Normalize(plankton::Copy(conclusion));
+    auto& cache = GetImplicationCache();
+    auto key = ImplicationCache::MakeKey(*normalizedPremise, *normalizedConclusion);
+    if (auto cached = cache.Get(key, config, *normalizedPremise, *normalizedConclusion)) return cached.value();
+
+    auto premiseKey = plankton::Copy(*normalizedPremise);
+    auto conclusionKey = plankton::Copy(*normalizedConclusion);
+    auto result = ComputeImplies(std::move(normalizedPremise), std::move(normalizedConclusion), config);
+    cache.Put(key, config, std::move(premiseKey), std::move(conclusionKey), result);
+    return result;
+}
@@ -92,12 +92,6 @@ inline bool IsEffectEmpty(const HeapEffect& effect) {
     return true;
 }
 
-inline bool AreEffectsEqual(const HeapEffect& effect, const HeapEffect& other) {
-    return plankton::SyntacticalEqual(*effect.pre, *other.pre)
-           && plankton::SyntacticalEqual(*effect.post, *other.post)
-           && plankton::SyntacticalEqual(*effect.context, *other.context);
-}
-
 inline void QuickFilter(std::deque<std::unique_ptr<HeapEffect>>& effects) {
     for (auto& effect : effects) {
         SymbolFactory factory;
@@ -108,16 +102,7 @@ inline void QuickFilter(std::deque<std::unique_ptr<HeapEffect>>& effects) {
         if (!IsEffectEmpty(*effect)) continue;
         effect.reset(nullptr);
     }
-    for (auto it = effects.begin(); it != effects.end(); ++it) {
-        if (!*it) continue;
-        for (auto ot = std::next(it); ot != effects.end(); ++ot) {
-            if (!*ot) continue;
-            if (!AreEffectsEqual(**it, **ot)) continue;
-            ot->reset(nullptr);
-        }
-    }
-
-    plankton::RemoveIf(effects, [](const auto& elem) { return !elem; });
+    plankton::RemoveDuplicateEffects(effects);
 }
 
 inline void RenameEffects(std::deque<std::unique_ptr<HeapEffect>>& effects, const std::deque<std::unique_ptr<HeapEffect>>& interference) {
@@ -191,3 +176,7 @@ bool Solver::AddInterference(std::deque<std::unique_ptr<HeapEffect>> effects) {
     plankton::MoveInto(std::move(effects), interference);
     return true;
 }
+
+const std::deque<std::unique_ptr<HeapEffect>>& Solver::GetInterference() const {
+    return interference;
+}
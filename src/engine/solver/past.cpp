@@ -513,8 +513,9 @@ struct Interpolator {
 
 };
 
-std::unique_ptr<Annotation> Solver::ImprovePast(std::unique_ptr<Annotation> annotation) const {
+std::unique_ptr<Annotation> Solver::ImprovePast(std::unique_ptr<Annotation> annotation, EffectFootprint* footprint) const {
     MEASURE("Solver::ImprovePast")
+    if (footprint) plankton::AddToFootprint(*annotation, *footprint); // interpolation relies on the interference for its memory
     if (annotation->past.empty()) return annotation;
     DEBUG("<<IMPROVE PAST>>" << std::endl)
     Interpolator(*annotation, interference, config).Interpolate();
@@ -1,6 +1,7 @@
 #include "engine/solver.hpp"
 
 #include "programs/util.hpp"
+#include "logics/util.hpp"
 
 using namespace plankton;
 
@@ -94,3 +95,11 @@ Solver::Solver(const Program& program, const SolverConfig& config) : config(conf
     AssumptionChecker checker;
     program.Accept(checker);
 }
+
+Solver::Solver(const Solver& other) : config(other.config), dataFlow(other.dataFlow) {
+    for (const auto& effect : other.interference) {
+        interference.push_back(std::make_unique<HeapEffect>(
+                plankton::Copy(*effect->pre), plankton::Copy(*effect->post), plankton::Copy(*effect->context)
+        ));
+    }
+}
@@ -132,8 +132,9 @@ struct InterferenceInfo {
     }
 };
 
-std::unique_ptr<Annotation> Solver::MakeInterferenceStable(std::unique_ptr<Annotation> annotation) const {
+std::unique_ptr<Annotation> Solver::MakeInterferenceStable(std::unique_ptr<Annotation> annotation, EffectFootprint* footprint) const {
     // TODO: should this take a list of annotations?
+    if (footprint) plankton::AddToFootprint(*annotation, *footprint); // stable only as long as no effect updates its memory
     if (interference.empty()) return annotation;
     if (plankton::Collect<SharedMemoryCore>(*annotation->now).empty()) return annotation;
 
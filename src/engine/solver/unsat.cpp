@@ -1,10 +1,147 @@
 #include "engine/solver.hpp"
 
 #include "engine/encoding.hpp"
+#include "logics/util.hpp"
+#include "util/timer.hpp"
 
 using namespace plankton;
 
 
+//
+// Syntactic contradictions
+//
+
+struct ContradictionFinder {
+    // only detects contradictions the encoding of the annotation is unsatisfiable for, see 'Encoding::Encode'
+    SymbolEquivalence equivalence;
+    std::deque<const MemoryAxiom*> memories;
+    std::deque<const EqualsToAxiom*> resources;
+    std::deque<const StackAxiom*> stack;
+    std::deque<const InflowEmptinessAxiom*> emptiness;
+    std::deque<const InflowContainsValueAxiom*> contains;
+
+    explicit ContradictionFinder(const SeparatingConjunction& formula) : equivalence(formula) {
+        Add(formula);
+        // a variable has one value
+        std::map<const VariableDeclaration*, const SymbolDeclaration*> values;
+        for (const auto* resource : resources) {
+            auto insertion = values.emplace(&resource->Variable(), &resource->Value());
+            if (!insertion.second) equivalence.Union(resource->Value(), *insertion.first->second);
+        }
+    }
+
+    void Add(const SeparatingConjunction& formula) {
+        // facts only, nested implications are not
+        for (const auto& conjunct : formula.conjuncts) {
+            if (auto conjunction = dynamic_cast<const SeparatingConjunction*>(conjunct.get())) Add(*conjunction);
+            else if (auto memory = dynamic_cast<const MemoryAxiom*>(conjunct.get())) memories.push_back(memory);
+            else if (auto resource = dynamic_cast<const EqualsToAxiom*>(conjunct.get())) resources.push_back(resource);
+            else if (auto axiom = dynamic_cast<const StackAxiom*>(conjunct.get())) stack.push_back(axiom);
+            else if (auto empty = dynamic_cast<const InflowEmptinessAxiom*>(conjunct.get())) emptiness.push_back(empty);
+            else if (auto value = dynamic_cast<const InflowContainsValueAxiom*>(conjunct.get())) contains.push_back(value);
+        }
+    }
+
+    [[nodiscard]] bool IsEqual(const SymbolDeclaration& symbol, const SymbolDeclaration& other) const {
+        return &equivalence.Find(symbol) == &equivalence.Find(other);
+    }
+
+    [[nodiscard]] bool IsContradictory() const {
+        return equivalence.IsContradictory() || HasNullMemory() || HasAliasingLocalMemory()
+               || ViolatesDataBounds() || HasExhaustedBool() || HasConflictingInflow();
+    }
+
+    [[nodiscard]] bool HasNullMemory() const {
+        // memory resources have non-null addresses
+        SymbolicNull null;
+        for (const auto* memory : memories) {
+            if (equivalence.AreEqual(*memory->node, null)) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool HasAliasingLocalMemory() const {
+        // local memory is distinct from all other memory and from what shared variables and shared memory point to
+        for (const auto* memory : memories) {
+            if (!plankton::IsLocal(*memory)) continue;
+            auto& address = memory->node->Decl();
+            for (const auto* other : memories) {
+                if (other != memory && IsEqual(address, other->node->Decl())) return true;
+                if (plankton::IsLocal(*other)) continue;
+                for (const auto& [field, value] : other->fieldToValue) {
+                    if (value->GetSort() == Sort::PTR && IsEqual(address, value->Decl())) return true;
+                }
+            }
+            for (const auto* resource : resources) {
+                if (resource->Variable().isShared && IsEqual(address, resource->Value())) return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool ViolatesDataBounds() const {
+        // data values range from MIN to MAX
+        SymbolicMin min;
+        SymbolicMax max;
+        for (const auto* axiom : stack) {
+            if (axiom->lhs->GetSort() != Sort::DATA) continue;
+            const SymbolicExpression* lower;
+            const SymbolicExpression* upper;
+            switch (axiom->op) {
+                case BinaryOperator::LT: lower = axiom->lhs.get(); upper = axiom->rhs.get(); break;
+                case BinaryOperator::GT: lower = axiom->rhs.get(); upper = axiom->lhs.get(); break;
+                default: continue;
+            }
+            if (equivalence.AreEqual(*lower, max) || equivalence.AreEqual(*upper, min)) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool HasExhaustedBool() const {
+        // booleans differing from both 'true' and 'false'
+        std::map<const SymbolDeclaration*, std::set<bool>> excluded;
+        for (const auto* axiom : stack) {
+            if (axiom->op != BinaryOperator::NEQ) continue;
+            auto variable = dynamic_cast<const SymbolicVariable*>(axiom->lhs.get());
+            auto value = dynamic_cast<const SymbolicBool*>(axiom->rhs.get());
+            if (!variable || !value) {
+                variable = dynamic_cast<const SymbolicVariable*>(axiom->rhs.get());
+                value = dynamic_cast<const SymbolicBool*>(axiom->lhs.get());
+            }
+            if (!variable || !value) continue;
+            auto& values = excluded[&equivalence.Find(variable->Decl())];
+            values.insert(value->value);
+            if (values.size() == 2) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool HasConflictingInflow() const {
+        // empty inflows contain nothing and are not non-empty
+        for (const auto* empty : emptiness) {
+            if (!empty->isEmpty) continue;
+            auto& flow = empty->flow->Decl();
+            for (const auto* other : emptiness) {
+                if (!other->isEmpty && IsEqual(flow, other->flow->Decl())) return true;
+            }
+            for (const auto* value : contains) {
+                if (IsEqual(flow, value->flow->Decl())) return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+//
+// Satisfiability
+//
+
 bool Solver::IsUnsatisfiable(const Annotation& annotation) const {
+    if (ContradictionFinder(*annotation.now).IsContradictory()) {
+        MEASURE("Solver::IsUnsatisfiable ~> syntactic")
+        return true;
+    }
+    MEASURE("Solver::IsUnsatisfiable ~> encoding")
     return Encoding(*annotation.now, config).ImpliesFalse();
 }
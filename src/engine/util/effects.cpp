@@ -1,5 +1,10 @@
 #include "engine/util.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+#include "logics/util.hpp"
+#include "util/shortcuts.hpp"
+
 using namespace plankton;
 
 
@@ -11,6 +16,31 @@ bool plankton::UpdatesField(const HeapEffect& effect, const std::string& field)
     return effect.pre->fieldToValue.at(field)->Decl() != effect.post->fieldToValue.at(field)->Decl();
 }
 
+void plankton::AddToFootprint(const HeapEffect& effect, EffectFootprint& footprint) {
+    const auto* type = &effect.pre->node->GetType();
+    if (plankton::UpdatesFlow(effect)) footprint.emplace(type, "");
+    for (const auto& pair : effect.pre->fieldToValue) {
+        if (plankton::UpdatesField(effect, pair.first)) footprint.emplace(type, pair.first);
+    }
+}
+
+inline void AddMemoryToFootprint(const SharedMemoryCore& memory, EffectFootprint& footprint) {
+    const auto* type = &memory.node->GetType();
+    footprint.emplace(type, "");
+    for (const auto& pair : memory.fieldToValue) footprint.emplace(type, pair.first);
+}
+
+void plankton::AddToFootprint(const Annotation& annotation, EffectFootprint& footprint) {
+    for (const auto* memory : plankton::Collect<SharedMemoryCore>(*annotation.now)) AddMemoryToFootprint(*memory, footprint);
+    for (const auto& past : annotation.past) AddMemoryToFootprint(*past->formula, footprint);
+}
+
+bool plankton::IsAffected(const EffectFootprint& footprint, const HeapEffect& effect) {
+    EffectFootprint updates;
+    plankton::AddToFootprint(effect, updates);
+    return plankton::NonEmptyIntersection(footprint, updates);
+}
+
 void plankton::AvoidEffectSymbols(SymbolFactory& factory, const HeapEffect& effect) {
     factory.Avoid(*effect.pre);
     factory.Avoid(*effect.post);
@@ -21,3 +51,30 @@ void plankton::AvoidEffectSymbols(SymbolFactory& factory, const std::deque<std::
     for (const auto& effect : effects) plankton::AvoidEffectSymbols(factory, *effect);
 }
 
+
+inline std::size_t HashEffect(const HeapEffect& effect) {
+    auto result = plankton::SyntacticalHash(*effect.pre);
+    result = result * 31 + plankton::SyntacticalHash(*effect.post);
+    return result * 31 + plankton::SyntacticalHash(*effect.context);
+}
+
+inline bool AreEffectsEqual(const HeapEffect& effect, const HeapEffect& other) {
+    return plankton::SyntacticalEqual(*effect.pre, *other.pre)
+           && plankton::SyntacticalEqual(*effect.post, *other.post)
+           && plankton::SyntacticalEqual(*effect.context, *other.context);
+}
+
+void plankton::RemoveDuplicateEffects(std::deque<std::unique_ptr<HeapEffect>>& effects) {
+    std::unordered_multimap<std::size_t, const HeapEffect*> seen;
+    for (auto& effect : effects) {
+        if (!effect) continue;
+        auto hash = HashEffect(*effect);
+        auto [begin, end] = seen.equal_range(hash);
+        auto isDuplicate = std::any_of(begin, end, [&effect](const auto& pair) {
+            return AreEffectsEqual(*pair.second, *effect);
+        });
+        if (isDuplicate) effect.reset(nullptr);
+        else seen.emplace(hash, effect.get());
+    }
+    plankton::RemoveIf(effects, [](const auto& elem) { return !elem; });
+}
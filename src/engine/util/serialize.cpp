@@ -0,0 +1,29 @@
+#include "engine/util.hpp"
+
+using namespace plankton;
+
+
+void plankton::Serialize(LogicWriter& writer, const HeapEffect& effect) {
+    writer.Write(*effect.pre);
+    writer.Write(*effect.post);
+    writer.Write(*effect.context);
+}
+
+void plankton::Serialize(LogicWriter& writer, const FutureSuggestion& suggestion) {
+    writer.Write(*suggestion.command);
+    if (suggestion.guard) writer.Write(*suggestion.guard);
+    else writer.Write(Guard());
+}
+
+std::unique_ptr<HeapEffect> plankton::DeserializeHeapEffect(LogicReader& reader) {
+    auto pre = reader.Read<SharedMemoryCore>();
+    auto post = reader.Read<SharedMemoryCore>();
+    auto context = reader.Read<Formula>();
+    return std::make_unique<HeapEffect>(std::move(pre), std::move(post), std::move(context));
+}
+
+std::unique_ptr<FutureSuggestion> plankton::DeserializeFutureSuggestion(LogicReader& reader) {
+    auto command = reader.ReadMemoryWrite();
+    auto guard = reader.Read<Guard>();
+    return std::make_unique<FutureSuggestion>(std::move(command), std::move(guard));
+}
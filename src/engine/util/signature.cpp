@@ -0,0 +1,36 @@
+#include "engine/util.hpp"
+
+#include <algorithm>
+#include "logics/util.hpp"
+#include "util/shortcuts.hpp"
+
+using namespace plankton;
+
+
+AnnotationSignature::AnnotationSignature(const Annotation& annotation) {
+    // memory resources are left out on purpose: Solver::Implies makes missing memory of the premise accessible
+    // before checking (see TryAvoidResourceMismatch), so the premise's memory shape need not match the conclusion's
+
+    for (const auto* resource : plankton::Collect<EqualsToAxiom>(*annotation.now)) {
+        variables.insert(&resource->Variable());
+    }
+    for (const auto* obligation : plankton::Collect<ObligationAxiom>(*annotation.now)) {
+        obligations[obligation->spec]++;
+    }
+    for (const auto* fulfillment : plankton::Collect<FulfillmentAxiom>(*annotation.now)) {
+        fulfillments.insert(fulfillment->returnValue);
+    }
+}
+
+bool AnnotationSignature::MayImply(const AnnotationSignature& conclusion) const {
+    // variable resources and fulfillments of the conclusion must be matched syntactically
+    if (variables != conclusion.variables) return false;
+    if (!std::includes(fulfillments.begin(), fulfillments.end(),
+                       conclusion.fulfillments.begin(), conclusion.fulfillments.end())) return false;
+    
+    // see QuickMismatchCheck
+    return plankton::All(conclusion.obligations, [this](const auto& pair) {
+        auto find = obligations.find(pair.first);
+        return find != obligations.end() && find->second >= pair.second;
+    });
+}
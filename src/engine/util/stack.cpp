@@ -1,5 +1,6 @@
 #include "engine/util.hpp"
 
+#include <unordered_map>
 #include "logics/util.hpp"
 #include "util/shortcuts.hpp"
 #include "util/log.hpp"
@@ -155,10 +156,127 @@ std::deque<std::unique_ptr<Axiom>> plankton::MakeStackCandidates(const LogicObje
     return result;
 }
 
+
+//
+// Candidate checking
+//
+
+struct Candidate {
+    std::unique_ptr<Axiom> canonical; // symbols replaced by the representative of their class
+    std::deque<std::unique_ptr<Axiom>> instances; // candidates represented by 'canonical'
+    bool holds = false;
+
+    explicit Candidate(std::unique_ptr<Axiom> canonical) : canonical(std::move(canonical)) {}
+};
+
+struct CandidateChecker {
+    Annotation& annotation;
+    Encoding& encoding;
+    SymbolEquivalence classes; // symbols known to be equal
+    std::deque<Candidate> candidates;
+    std::unordered_multimap<std::size_t, std::size_t> lookup; // hash of 'canonical' ~> position in 'candidates'
+
+    explicit CandidateChecker(Annotation& annotation, Encoding& encoding)
+            : annotation(annotation), encoding(encoding), classes(*annotation.now) {}
+
+    void Add(std::unique_ptr<Axiom> candidate) {
+        if (TryResolveStatically(candidate)) return;
+        auto canonical = plankton::Copy(*candidate);
+        plankton::RenameSymbols(*canonical, [this](const auto& symbol) -> const SymbolDeclaration& {
+            return classes.Find(symbol);
+        });
+        auto& entry = Lookup(std::move(canonical));
+        entry.instances.push_back(std::move(candidate));
+    }
+
+    void Check() {
+        // weak data comparisons are mostly decided by the strong ones ('a < b' implies 'a <= b' and 'a != b')
+        for (auto& candidate : candidates) {
+            if (!IsWeak(*candidate.canonical)) AddCheck(candidate);
+        }
+        encoding.Check(CheckMode::OPTIONAL);
+        for (auto& candidate : candidates) {
+            if (!IsWeak(*candidate.canonical)) continue;
+            auto decided = Decide(candidate);
+            if (!decided.has_value()) AddCheck(candidate);
+            else if (decided.value()) Accept(candidate);
+        }
+        encoding.Check(CheckMode::OPTIONAL);
+    }
+
+private:
+    Candidate& Lookup(std::unique_ptr<Axiom> canonical) {
+        auto hash = plankton::SyntacticalHash(*canonical);
+        auto [begin, end] = lookup.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            auto& candidate = candidates.at(it->second);
+            if (plankton::SyntacticalEqual(*candidate.canonical, *canonical)) return candidate;
+        }
+        lookup.emplace(hash, candidates.size());
+        candidates.emplace_back(std::move(canonical));
+        return candidates.back();
+    }
+
+    bool TryResolveStatically(std::unique_ptr<Axiom>& candidate) {
+        auto stack = dynamic_cast<const StackAxiom*>(candidate.get());
+        if (!stack) return false;
+        auto lhs = dynamic_cast<const SymbolicVariable*>(stack->lhs.get());
+        auto rhs = dynamic_cast<const SymbolicVariable*>(stack->rhs.get());
+        if (!lhs || !rhs) return false;
+        if (lhs->GetSort() != rhs->GetSort()) return true; // ill-sorted comparisons cannot be encoded
+        if (&classes.Find(lhs->Decl()) != &classes.Find(rhs->Decl())) return false;
+        // equal symbols satisfy exactly the reflexive comparisons
+        auto op = stack->op;
+        if (op == BinaryOperator::EQ || op == BinaryOperator::LEQ || op == BinaryOperator::GEQ) {
+            annotation.Conjoin(std::move(candidate));
+        }
+        return true;
+    }
+
+    static const StackAxiom* AsDataComparison(const Axiom& axiom) {
+        auto stack = dynamic_cast<const StackAxiom*>(&axiom);
+        if (!stack || stack->lhs->GetSort() != Sort::DATA) return nullptr;
+        return stack;
+    }
+
+    static bool IsWeak(const Axiom& axiom) {
+        auto stack = AsDataComparison(axiom);
+        if (!stack) return false;
+        return stack->op == BinaryOperator::NEQ || stack->op == BinaryOperator::LEQ || stack->op == BinaryOperator::GEQ;
+    }
+
+    std::optional<bool> Decide(const Candidate& candidate) {
+        const auto& weak = *AsDataComparison(*candidate.canonical);
+        auto holds = [this, &weak](BinaryOperator op) {
+            StackAxiom strong(op, plankton::Copy(*weak.lhs), plankton::Copy(*weak.rhs));
+            auto [begin, end] = lookup.equal_range(plankton::SyntacticalHash(strong));
+            for (auto it = begin; it != end; ++it) {
+                const auto& other = candidates.at(it->second);
+                if (plankton::SyntacticalEqual(*other.canonical, strong)) return other.holds;
+            }
+            return false;
+        };
+        if (holds(BinaryOperator::EQ)) return weak.op != BinaryOperator::NEQ;
+        if (holds(BinaryOperator::LT)) return weak.op != BinaryOperator::GEQ;
+        if (holds(BinaryOperator::GT)) return weak.op != BinaryOperator::LEQ;
+        return std::nullopt;
+    }
+
+    void AddCheck(Candidate& candidate) {
+        encoding.AddCheck(encoding.Encode(*candidate.canonical), [this, &candidate](bool holds) {
+            candidate.holds = holds;
+            if (holds) Accept(candidate);
+        });
+    }
+
+    void Accept(Candidate& candidate) {
+        candidate.holds = true;
+        for (auto& instance : candidate.instances) annotation.Conjoin(std::move(instance));
+        candidate.instances.clear();
+    }
+};
+
 void plankton::ExtendStack(Annotation& annotation, Encoding& encoding, ExtensionPolicy policy) {
-    // Generator generator(policy);
-    // generator.AddSymbolsFrom(annotation);
-    // auto candidates = generator.Generate();
     auto candidates = plankton::MakeStackCandidates(*annotation.now, policy);
     for (const auto& past : annotation.past) {
         auto pastCandidates = plankton::MakeStackCandidates(*annotation.now, *past, policy);
@@ -169,14 +287,10 @@ void plankton::ExtendStack(Annotation& annotation, Encoding& encoding, Extension
         plankton::MoveInto(std::move(futureCandidates), candidates);
     }
     // DEBUG("plankton::ExtendStack for " << candidates.size() << " candidates" << std::endl)
-    
-    for (auto& candidate : candidates) {
-        encoding.AddCheck(encoding.Encode(*candidate), [&candidate,&annotation](bool holds){
-            assert(candidate);
-            if (holds) annotation.Conjoin(std::move(candidate));
-        });
-    }
-    encoding.Check();
+
+    CandidateChecker checker(annotation, encoding);
+    for (auto& candidate : candidates) checker.Add(std::move(candidate));
+    checker.Check();
 }
 
 void plankton::ExtendStack(Annotation& annotation, const SolverConfig& config, ExtensionPolicy policy) {
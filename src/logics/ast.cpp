@@ -1,5 +1,6 @@
 #include "logics/ast.hpp"
 
+#include <mutex>
 #include <utility>
 
 #include "logics/util.hpp"
@@ -14,6 +15,7 @@ using namespace plankton;
 
 bool SymbolDeclaration::operator==(const SymbolDeclaration& other) const { return this == &other; }
 bool SymbolDeclaration::operator!=(const SymbolDeclaration& other) const { return this != &other; }
+std::size_t SymbolDeclaration::GetPoolIndex() const { return poolIndex; }
 
 inline constexpr std::string_view MakeNamePrefix(Sort sort, Order order) {
     switch (order) {
@@ -45,8 +47,19 @@ inline std::string MakeName(const Type& type, Order order, std::size_t counter)
     return result;
 }
 
-SymbolDeclaration::SymbolDeclaration(std::string name, const Type& type, Order order)
-        : name(std::move(name)), type(type), order(order) {
+SymbolDeclaration::SymbolDeclaration(std::string name, const Type& type, Order order, std::size_t poolIndex)
+        : name(std::move(name)), type(type), order(order), poolIndex(poolIndex) {
+}
+
+struct SymbolPool {
+    std::mutex mutex;
+    std::size_t count = 0;
+    std::map<std::pair<const Type*, Order>, std::deque<std::unique_ptr<SymbolDeclaration>>> symbols; // in creation order
+};
+
+inline SymbolPool& GetSymbolPool() {
+    static SymbolPool pool;
+    return pool;
 }
 
 SymbolFactory::SymbolFactory() = default;
@@ -57,31 +70,37 @@ SymbolFactory::SymbolFactory(const LogicObject& avoid) {
 
 void SymbolFactory::Avoid(const LogicObject& avoid) {
     auto symbols = plankton::Collect<SymbolDeclaration>(avoid);
-    plankton::InsertInto(std::move(symbols), inUse);
+    for (const auto* decl : symbols) MarkInUse(*decl);
+}
+
+void SymbolFactory::MarkInUse(const SymbolDeclaration& decl) {
+    auto& list = freeLists[{ &decl.type, decl.order }];
+    if (list.inUse.size() <= decl.poolIndex) list.inUse.resize(decl.poolIndex + 1, false);
+    list.inUse[decl.poolIndex] = true;
 }
 
 const SymbolDeclaration& SymbolFactory::GetFresh(const Type& type, Order order) {
-    static std::deque<std::unique_ptr<SymbolDeclaration>> symbols;
-
-    // try to find existing symbol
-    // TODO: implement more efficiently
-    auto find = FindIf(symbols, [this, &type, order](const auto& elem) {
-        assert(elem);
-        return elem->type == type && elem->order == order && inUse.count(elem.get()) == 0;
-    });
+    auto& pool = GetSymbolPool();
+    std::lock_guard<std::mutex> guard(pool.mutex);
+    auto& symbols = pool.symbols[{ &type, order }];
+    auto& list = freeLists[{ &type, order }];
+
+    // find first existing symbol not in use, symbols are never released so the cursor only moves forward
+    while (list.cursor < list.inUse.size() && list.inUse[list.cursor]) ++list.cursor;
     
     const SymbolDeclaration* result;
-    if (find != symbols.end()) {
-        result = find->get();
+    if (list.cursor < symbols.size()) {
+        result = symbols.at(list.cursor).get();
     } else {
         // make new symbol
         assert(order == Order::FIRST || type == Type::Data());
-        symbols.emplace_back(new SymbolDeclaration(MakeName(type, order, symbols.size()), type, order));
+        auto name = MakeName(type, order, pool.count++);
+        symbols.emplace_back(new SymbolDeclaration(std::move(name), type, order, symbols.size()));
         result = symbols.back().get();
     }
     
     assert(result);
-    inUse.insert(result);
+    MarkInUse(*result);
     return *result;
 }
 
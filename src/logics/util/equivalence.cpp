@@ -0,0 +1,116 @@
+#include "logics/util.hpp"
+
+using namespace plankton;
+
+
+inline bool IsImmediate(const SymbolicExpression& expression) {
+    return dynamic_cast<const SymbolicVariable*>(&expression) == nullptr;
+}
+
+inline bool AreDistinct(const SymbolicExpression& value, const SymbolicExpression& other) {
+    // immediates with distinct fixed values; 'self' and 'some' may denote the same thread
+    if (auto boolean = dynamic_cast<const SymbolicBool*>(&value)) {
+        auto otherBoolean = dynamic_cast<const SymbolicBool*>(&other);
+        return otherBoolean && boolean->value != otherBoolean->value;
+    }
+    auto isMin = [](const auto& expr) { return dynamic_cast<const SymbolicMin*>(&expr) != nullptr; };
+    auto isMax = [](const auto& expr) { return dynamic_cast<const SymbolicMax*>(&expr) != nullptr; };
+    auto isUnlocked = [](const auto& expr) { return dynamic_cast<const SymbolicUnlocked*>(&expr) != nullptr; };
+    auto isThread = [](const auto& expr) {
+        return dynamic_cast<const SymbolicSelfTid*>(&expr) != nullptr || dynamic_cast<const SymbolicSomeTid*>(&expr) != nullptr;
+    };
+    if (isMin(value) && isMax(other)) return true;
+    if (isMax(value) && isMin(other)) return true;
+    if (isUnlocked(value) && isThread(other)) return true;
+    if (isThread(value) && isUnlocked(other)) return true;
+    return false;
+}
+
+SymbolEquivalence::SymbolEquivalence(const SeparatingConjunction& formula) {
+    Add(formula);
+}
+
+void SymbolEquivalence::Add(const SeparatingConjunction& formula) {
+    for (const auto& conjunct : formula.conjuncts) {
+        if (auto conjunction = dynamic_cast<const SeparatingConjunction*>(conjunct.get())) Add(*conjunction);
+        else if (auto axiom = dynamic_cast<const StackAxiom*>(conjunct.get())) Add(*axiom);
+    }
+}
+
+void SymbolEquivalence::Add(const StackAxiom& axiom) {
+    switch (axiom.op) {
+        case BinaryOperator::EQ: {
+            auto lhs = dynamic_cast<const SymbolicVariable*>(axiom.lhs.get());
+            auto rhs = dynamic_cast<const SymbolicVariable*>(axiom.rhs.get());
+            if (lhs && rhs) Union(lhs->Decl(), rhs->Decl());
+            else if (lhs) AddValue(lhs->Decl(), *axiom.rhs);
+            else if (rhs) AddValue(rhs->Decl(), *axiom.lhs);
+            else if (AreDistinct(*axiom.lhs, *axiom.rhs)) contradictory = true;
+            break;
+        }
+        case BinaryOperator::NEQ:
+        case BinaryOperator::LT:
+        case BinaryOperator::GT:
+            disequalities.emplace_back(plankton::Copy(*axiom.lhs), plankton::Copy(*axiom.rhs));
+            break;
+        case BinaryOperator::LEQ:
+        case BinaryOperator::GEQ:
+            break;
+    }
+}
+
+const SymbolDeclaration& SymbolEquivalence::Find(const SymbolDeclaration& symbol) const {
+    auto find = parent.find(&symbol);
+    if (find == parent.end()) return symbol;
+    auto& root = Find(*find->second);
+    find->second = &root; // path compression
+    return root;
+}
+
+void SymbolEquivalence::Union(const SymbolDeclaration& symbol, const SymbolDeclaration& other) {
+    auto& symbolRoot = Find(symbol);
+    auto& otherRoot = Find(other);
+    if (&symbolRoot == &otherRoot) return;
+    parent[&symbolRoot] = &otherRoot;
+
+    auto find = values.find(&symbolRoot);
+    if (find == values.end()) return;
+    auto value = std::move(find->second);
+    values.erase(find);
+    AddValue(otherRoot, *value);
+}
+
+void SymbolEquivalence::AddValue(const SymbolDeclaration& symbol, const SymbolicExpression& value) {
+    auto& root = Find(symbol);
+    auto find = values.find(&root);
+    if (find == values.end()) values[&root] = plankton::Copy(value);
+    else if (AreDistinct(*find->second, value)) contradictory = true;
+}
+
+const SymbolicExpression* SymbolEquivalence::Resolve(const SymbolicExpression& expression) const {
+    if (IsImmediate(expression)) return &expression;
+    auto find = values.find(&Find(dynamic_cast<const SymbolicVariable&>(expression).Decl()));
+    if (find == values.end()) return nullptr;
+    return find->second.get();
+}
+
+bool SymbolEquivalence::AreEqual(const SymbolicExpression& expression, const SymbolicExpression& other) const {
+    auto variable = dynamic_cast<const SymbolicVariable*>(&expression);
+    auto otherVariable = dynamic_cast<const SymbolicVariable*>(&other);
+    if (variable && otherVariable && &Find(variable->Decl()) == &Find(otherVariable->Decl())) return true;
+    auto value = Resolve(expression);
+    auto otherValue = Resolve(other);
+    return value && otherValue && plankton::SyntacticalEqual(*value, *otherValue);
+}
+
+bool SymbolEquivalence::IsContradictory() const {
+    if (contradictory) return true;
+    for (const auto& [lhs, rhs] : disequalities) {
+        if (AreEqual(*lhs, *rhs)) return true;
+    }
+    return false;
+}
+
+SymbolRenaming SymbolEquivalence::MakeRenaming() const {
+    return [this](const SymbolDeclaration& symbol) -> const SymbolDeclaration& { return Find(symbol); };
+}
@@ -0,0 +1,145 @@
+#include "logics/util.hpp"
+
+#include <algorithm>
+#include <typeinfo>
+
+using namespace plankton;
+
+
+//
+// Structural hashing, consistent with 'SyntacticalEqual'
+//
+
+inline std::size_t Combine(std::size_t seed, std::size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+template<typename T>
+inline std::size_t Seed(const T& /*object*/) {
+    return typeid(T).hash_code();
+}
+
+inline std::size_t Hash(const SymbolicVariable& object) {
+    return Combine(Seed(object), std::hash<const SymbolDeclaration*>()(&object.Decl()));
+}
+inline std::size_t Hash(const SymbolicBool& object) { return Combine(Seed(object), object.value ? 1 : 0); }
+inline std::size_t Hash(const SymbolicNull& object) { return Seed(object); }
+inline std::size_t Hash(const SymbolicMin& object) { return Seed(object); }
+inline std::size_t Hash(const SymbolicMax& object) { return Seed(object); }
+inline std::size_t Hash(const SymbolicSelfTid& object) { return Seed(object); }
+inline std::size_t Hash(const SymbolicSomeTid& object) { return Seed(object); }
+inline std::size_t Hash(const SymbolicUnlocked& object) { return Seed(object); }
+
+template<typename T>
+inline std::size_t HashMemory(const T& object) {
+    auto result = Combine(Seed(object), Hash(*object.node));
+    result = Combine(result, Hash(*object.flow));
+    for (const auto& [field, value] : object.fieldToValue) result = Combine(result, Hash(*value));
+    return result;
+}
+inline std::size_t Hash(const LocalMemoryResource& object) { return HashMemory(object); }
+inline std::size_t Hash(const SharedMemoryCore& object) { return HashMemory(object); }
+inline std::size_t Hash(const EqualsToAxiom& object) {
+    auto result = Combine(Seed(object), std::hash<const VariableDeclaration*>()(&object.Variable()));
+    return Combine(result, Hash(*object.value));
+}
+inline std::size_t Hash(const StackAxiom& object) {
+    // 'a < b' and 'b > a' are syntactically equal, hash both orientations symmetrically
+    auto hashOriented = [&object](BinaryOperator op, const SymbolicExpression& lhs, const SymbolicExpression& rhs) {
+        auto result = Combine(Seed(object), static_cast<std::size_t>(op));
+        result = Combine(result, plankton::SyntacticalHash(lhs));
+        return Combine(result, plankton::SyntacticalHash(rhs));
+    };
+    auto result = hashOriented(object.op, *object.lhs, *object.rhs);
+    if (object.op == Symmetric(object.op)) return result;
+    return std::min(result, hashOriented(Symmetric(object.op), *object.rhs, *object.lhs));
+}
+inline std::size_t Hash(const InflowEmptinessAxiom& object) {
+    return Combine(Combine(Seed(object), object.isEmpty ? 1 : 0), Hash(*object.flow));
+}
+inline std::size_t Hash(const InflowContainsValueAxiom& object) {
+    return Combine(Combine(Seed(object), Hash(*object.flow)), Hash(*object.value));
+}
+inline std::size_t Hash(const InflowContainsRangeAxiom& object) {
+    auto result = Combine(Seed(object), Hash(*object.flow));
+    result = Combine(result, plankton::SyntacticalHash(*object.valueLow));
+    return Combine(result, plankton::SyntacticalHash(*object.valueHigh));
+}
+inline std::size_t Hash(const ObligationAxiom& object) {
+    return Combine(Combine(Seed(object), static_cast<std::size_t>(object.spec)), Hash(*object.key));
+}
+inline std::size_t Hash(const FulfillmentAxiom& object) {
+    return Combine(Seed(object), object.returnValue ? 1 : 0);
+}
+
+template<typename T>
+inline std::size_t HashConjuncts(const T& object) {
+    auto result = Seed(object);
+    for (const auto& conjunct : object.conjuncts) result = Combine(result, plankton::SyntacticalHash(*conjunct));
+    return result;
+}
+inline std::size_t Hash(const SeparatingConjunction& object) { return HashConjuncts(object); }
+inline std::size_t Hash(const ImplicationSet& object) { return HashConjuncts(object); }
+inline std::size_t Hash(const NonSeparatingImplication& object) {
+    return Combine(Combine(Seed(object), Hash(*object.premise)), Hash(*object.conclusion));
+}
+
+inline std::size_t Hash(const PastPredicate& object) {
+    return Combine(Seed(object), Hash(*object.formula));
+}
+
+// program expressions in guards/updates are not hashed, only their number
+inline std::size_t Hash(const Guard& object) {
+    return Combine(Seed(object), object.conjuncts.size());
+}
+inline std::size_t Hash(const Update& object) {
+    auto result = Combine(Seed(object), object.fields.size());
+    for (const auto& value : object.values) result = Combine(result, plankton::SyntacticalHash(*value));
+    return result;
+}
+inline std::size_t Hash(const FuturePredicate& object) {
+    return Combine(Combine(Seed(object), Hash(*object.guard)), Hash(*object.update));
+}
+
+inline std::size_t Hash(const Annotation& object) {
+    auto result = Combine(Seed(object), Hash(*object.now));
+    for (const auto& past : object.past) result = Combine(result, Hash(*past));
+    for (const auto& future : object.future) result = Combine(result, Hash(*future));
+    return result;
+}
+
+struct LogicHasher : public LogicVisitor {
+    std::size_t result = 0;
+    
+    void Visit(const SymbolicVariable& object) override { result = Hash(object); }
+    void Visit(const SymbolicBool& object) override { result = Hash(object); }
+    void Visit(const SymbolicNull& object) override { result = Hash(object); }
+    void Visit(const SymbolicMin& object) override { result = Hash(object); }
+    void Visit(const SymbolicMax& object) override { result = Hash(object); }
+    void Visit(const SymbolicSelfTid& object) override { result = Hash(object); }
+    void Visit(const SymbolicSomeTid& object) override { result = Hash(object); }
+    void Visit(const SymbolicUnlocked& object) override { result = Hash(object); }
+    void Visit(const Guard& object) override { result = Hash(object); }
+    void Visit(const Update& object) override { result = Hash(object); }
+    void Visit(const SeparatingConjunction& object) override { result = Hash(object); }
+    void Visit(const LocalMemoryResource& object) override { result = Hash(object); }
+    void Visit(const SharedMemoryCore& object) override { result = Hash(object); }
+    void Visit(const EqualsToAxiom& object) override { result = Hash(object); }
+    void Visit(const StackAxiom& object) override { result = Hash(object); }
+    void Visit(const InflowEmptinessAxiom& object) override { result = Hash(object); }
+    void Visit(const InflowContainsValueAxiom& object) override { result = Hash(object); }
+    void Visit(const InflowContainsRangeAxiom& object) override { result = Hash(object); }
+    void Visit(const ObligationAxiom& object) override { result = Hash(object); }
+    void Visit(const FulfillmentAxiom& object) override { result = Hash(object); }
+    void Visit(const NonSeparatingImplication& object) override { result = Hash(object); }
+    void Visit(const ImplicationSet& object) override { result = Hash(object); }
+    void Visit(const PastPredicate& object) override { result = Hash(object); }
+    void Visit(const FuturePredicate& object) override { result = Hash(object); }
+    void Visit(const Annotation& object) override { result = Hash(object); }
+};
+
+std::size_t plankton::SyntacticalHash(const LogicObject& object) {
+    LogicHasher hasher;
+    object.Accept(hasher);
+    return hasher.result;
+}
@@ -56,17 +56,6 @@ inline std::size_t GetIncidence(const T& object) {
 // Ordering non-virtual expressions/axioms
 //
 
-static struct SymbolOrder {
-    std::map<const SymbolDeclaration*, std::size_t> symbolToIndex;
-
-    inline std::size_t Get(const SymbolDeclaration& decl) {
-        auto find = symbolToIndex.find(&decl);
-        if (find == symbolToIndex.end()) find = symbolToIndex.emplace(&decl, symbolToIndex.size()).first;
-        return find->second;
-    }
-} ordering;
-
-
 inline bool LLessLogic(const LogicObject& object, const LogicObject& other);
 inline bool LLessProgram(const Expression& object, const Expression& other);
 
@@ -87,8 +76,11 @@ inline bool LLess(const VariableDeclaration& decl, const VariableDeclaration& ot
 }
 
 inline bool LLess(const SymbolDeclaration& decl, const SymbolDeclaration& other) {
-    // return &decl < &other;
-    return ordering.Get(decl) < ordering.Get(other);
+    // independent of the order in which (concurrent) callers create symbols, unlike comparing addresses
+    if (decl.type.sort != other.type.sort) return decl.type.sort < other.type.sort;
+    if (decl.order != other.order) return decl.order < other.order;
+    if (decl.type.name != other.type.name) return decl.type.name < other.type.name;
+    return decl.GetPoolIndex() < other.GetPoolIndex();
 }
 
 inline bool LLess(const VariableExpression& object, const VariableExpression& other) {
@@ -383,8 +375,7 @@ inline void ApplyRenaming(Annotation& annotation) {
         void Visit(const InflowContainsValueAxiom&) override { /* do nothing */ }
         void Visit(const InflowContainsRangeAxiom&) override { /* do nothing */ }
         void Enter(const SymbolDeclaration& object) override {
-            ordering.Get(renaming(object));
-            // (void) renaming(object);
+            (void) renaming(object); // symbols are drawn in order of occurrence, so their pool index follows it
         }
     } collector;
     annotation.Accept(collector);
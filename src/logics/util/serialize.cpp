@@ -0,0 +1,750 @@
+#include "logics/serialize.hpp"
+
+#include <array>
+#include <cstdint>
+#include "programs/util.hpp"
+#include "logics/util.hpp"
+
+using namespace plankton;
+
+
+//
+// Tags
+//
+
+enum struct Tag : std::uint8_t {
+    SYMBOL, BOOL, NULL_, MIN, MAX, SELF, SOME, UNLOCKED,
+    SEPARATING, LOCAL, SHARED, FIELD, EQUALS, STACK, INFLOW_EMPTY, INFLOW_CONTAINS, INFLOW_RANGE, OBLIGATION,
+    FULFILLMENT, IMPLICATION, IMPLICATION_SET, PAST, GUARD, UPDATE, FUTURE, ANNOTATION,
+    VARIABLE, TRUE_, FALSE_, MIN_VALUE, MAX_VALUE, NULL_VALUE, DEREFERENCE, BINARY, MEMORY_WRITE,
+    LAST_ // end marker, keep last
+};
+
+static constexpr std::size_t TAG_COUNT = static_cast<std::size_t>(Tag::LAST_);
+
+static const std::array<std::string, TAG_COUNT> TAG_NAMES = {
+    "sym", "bool", "null", "min", "max", "self", "some", "unlocked",
+    "sep", "local", "shared", "field", "equals", "stack", "inflow-empty", "inflow-contains", "inflow-range", "obligation",
+    "fulfillment", "implication", "implications", "past", "guard", "update", "future", "annotation",
+    "var", "true", "false", "MIN", "MAX", "NULL", "deref", "binary", "write"
+};
+
+inline Tag TagFromName(const std::string& name) {
+    for (std::size_t index = 0; index < TAG_COUNT; ++index) {
+        if (TAG_NAMES[index] == name) return static_cast<Tag>(index);
+    }
+    throw std::logic_error("Deserialization failed: unknown tag '" + name + "'."); // TODO: better error handling
+}
+
+static const std::array<std::string, 6> OPERATOR_NAMES = { "==", "!=", "<=", "<", ">=", ">" };
+static const std::array<std::string, 3> SPECIFICATION_NAMES = { "contains", "insert", "delete" };
+
+inline BinaryOperator OperatorFromName(const std::string& name) {
+    for (std::size_t index = 0; index < OPERATOR_NAMES.size(); ++index) {
+        if (OPERATOR_NAMES[index] == name) return static_cast<BinaryOperator>(index);
+    }
+    throw std::logic_error("Deserialization failed: unknown operator '" + name + "'."); // TODO: better error handling
+}
+
+inline Specification SpecificationFromName(const std::string& name) {
+    for (std::size_t index = 0; index < SPECIFICATION_NAMES.size(); ++index) {
+        if (SPECIFICATION_NAMES[index] == name) return static_cast<Specification>(index);
+    }
+    throw std::logic_error("Deserialization failed: unknown specification '" + name + "'."); // TODO: better error handling
+}
+
+
+//
+// Sinks and sources
+//
+
+struct plankton::SerializationSink {
+    virtual ~SerializationSink() = default;
+    virtual void Open(Tag tag) = 0;
+    virtual void String(const std::string& string) = 0;
+    virtual void Number(std::uint64_t number) = 0;
+    virtual void Close() = 0;
+    virtual void Finish() = 0; // after every top-level object
+};
+
+struct plankton::SerializationSource {
+    virtual ~SerializationSource() = default;
+    virtual Tag Open() = 0;
+    virtual std::string String() = 0;
+    virtual std::uint64_t Number() = 0;
+    virtual bool PeekClose() = 0;
+    virtual void Close() = 0;
+    virtual bool AtEnd() = 0;
+};
+
+inline void Malformed(const std::string& reason) {
+    throw std::logic_error("Deserialization failed: " + reason + "."); // TODO: better error handling
+}
+
+struct TextSink final : public SerializationSink {
+    std::ostream& stream;
+    bool separate = false;
+
+    explicit TextSink(std::ostream& stream) : stream(stream) {}
+
+    void Separate() {
+        if (separate) stream << ' ';
+        separate = true;
+    }
+    void Open(Tag tag) override {
+        Separate();
+        stream << '(' << TAG_NAMES.at(static_cast<std::size_t>(tag));
+    }
+    void String(const std::string& string) override {
+        Separate();
+        stream << '"';
+        for (auto chr : string) {
+            if (chr == '"' || chr == '\\') stream << '\\';
+            stream << chr;
+        }
+        stream << '"';
+    }
+    void Number(std::uint64_t number) override {
+        Separate();
+        stream << number;
+    }
+    void Close() override { stream << ')'; }
+    void Finish() override {
+        stream << std::endl;
+        separate = false;
+    }
+};
+
+struct TextSource final : public SerializationSource {
+    std::istream& stream;
+
+    explicit TextSource(std::istream& stream) : stream(stream) {}
+
+    int Peek() {
+        while (std::isspace(stream.peek())) stream.get();
+        return stream.peek();
+    }
+    void Expect(char expected) {
+        if (Peek() != expected) Malformed(std::string("expected '") + expected + "'");
+        stream.get();
+    }
+    Tag Open() override {
+        Expect('(');
+        std::string name;
+        while (stream.peek() != EOF && !std::isspace(stream.peek()) && stream.peek() != '(' && stream.peek() != ')') {
+            name.push_back(static_cast<char>(stream.get()));
+        }
+        return TagFromName(name);
+    }
+    std::string String() override {
+        Expect('"');
+        std::string result;
+        while (true) {
+            auto chr = stream.get();
+            if (chr == EOF) Malformed("unterminated string");
+            if (chr == '"') return result;
+            if (chr == '\\') chr = stream.get();
+            result.push_back(static_cast<char>(chr));
+        }
+    }
+    std::uint64_t Number() override {
+        if (!std::isdigit(Peek())) Malformed("expected number");
+        std::uint64_t result;
+        stream >> result;
+        return result;
+    }
+    bool PeekClose() override { return Peek() == ')'; }
+    void Close() override { Expect(')'); }
+    bool AtEnd() override { return Peek() == EOF; }
+};
+
+struct BinarySink final : public SerializationSink {
+    std::ostream& stream;
+
+    explicit BinarySink(std::ostream& stream) : stream(stream) {}
+
+    void Open(Tag tag) override { stream.put(static_cast<char>(static_cast<std::uint8_t>(tag) + 1)); }
+    void String(const std::string& string) override {
+        Number(string.size());
+        stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+    }
+    void Number(std::uint64_t number) override {
+        // LEB128
+        do {
+            std::uint8_t byte = number & 0x7f;
+            number >>= 7;
+            if (number != 0) byte |= 0x80;
+            stream.put(static_cast<char>(byte));
+        } while (number != 0);
+    }
+    void Close() override { stream.put(0); }
+    void Finish() override {}
+};
+
+struct BinarySource final : public SerializationSource {
+    std::istream& stream;
+
+    explicit BinarySource(std::istream& stream) : stream(stream) {}
+
+    std::uint8_t Byte() {
+        auto chr = stream.get();
+        if (chr == EOF) Malformed("unexpected end of input");
+        return static_cast<std::uint8_t>(chr);
+    }
+    Tag Open() override {
+        auto byte = Byte();
+        if (byte == 0 || byte > TAG_COUNT) Malformed("expected tag");
+        return static_cast<Tag>(byte - 1);
+    }
+    std::string String() override {
+        auto size = Number();
+        std::string result(size, '\0');
+        stream.read(result.data(), static_cast<std::streamsize>(size));
+        if (static_cast<std::uint64_t>(stream.gcount()) != size) Malformed("unexpected end of input");
+        return result;
+    }
+    std::uint64_t Number() override {
+        std::uint64_t result = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            auto byte = Byte();
+            result |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return result;
+        }
+        Malformed("malformed number");
+        return result;
+    }
+    bool PeekClose() override { return stream.peek() == 0; }
+    void Close() override { if (Byte() != 0) Malformed("expected end of object"); }
+    bool AtEnd() override { return stream.peek() == EOF; }
+};
+
+inline std::unique_ptr<SerializationSink> MakeSink(std::ostream& stream, SerializationFormat format) {
+    if (format == SerializationFormat::BINARY) return std::make_unique<BinarySink>(stream);
+    return std::make_unique<TextSink>(stream);
+}
+
+inline std::unique_ptr<SerializationSource> MakeSource(std::istream& stream, SerializationFormat format) {
+    if (format == SerializationFormat::BINARY) return std::make_unique<BinarySource>(stream);
+    return std::make_unique<TextSource>(stream);
+}
+
+
+//
+// Program entities
+//
+
+template<typename F>
+inline void ForEachVariable(const Program& program, const F& handle) {
+    // identifies variables by their function ("" for shared ones), name, and occurrence within the function
+    struct : public ProgramListener {
+        std::string scope;
+        std::map<std::pair<std::string, std::string>, std::size_t> occurrences;
+        std::deque<std::tuple<const VariableDeclaration*, std::string, std::string>> result;
+        void Enter(const Function& object) override { scope = object.name; }
+        void Enter(const VariableDeclaration& object) override {
+            auto occurrence = occurrences[{ scope, object.name }]++;
+            auto id = occurrence == 0 ? object.name : object.name + "#" + std::to_string(occurrence);
+            result.emplace_back(&object, scope, id);
+        }
+    } collector;
+    program.Accept(collector);
+    for (const auto& [decl, scope, id] : collector.result) handle(*decl, scope, id);
+}
+
+
+//
+// Writing
+//
+
+struct LogicObjectWriter : public LogicVisitor {
+    SerializationSink& sink;
+    const std::map<const VariableDeclaration*, std::pair<std::string, std::string>>& variables;
+
+    explicit LogicObjectWriter(SerializationSink& sink, decltype(variables) variables) : sink(sink), variables(variables) {}
+
+    void Write(const VariableDeclaration& decl) {
+        auto find = variables.find(&decl);
+        if (find == variables.end()) throw std::logic_error("Serialization failed: unknown variable '" + decl.name + "'."); // TODO: better error handling
+        sink.Open(Tag::VARIABLE);
+        sink.String(find->second.first);
+        sink.String(find->second.second);
+        sink.Close();
+    }
+
+    void Write(const Expression& expression) {
+        if (auto var = dynamic_cast<const VariableExpression*>(&expression)) return Write(var->Decl());
+        if (dynamic_cast<const TrueValue*>(&expression)) return Leaf(Tag::TRUE_);
+        if (dynamic_cast<const FalseValue*>(&expression)) return Leaf(Tag::FALSE_);
+        if (dynamic_cast<const MinValue*>(&expression)) return Leaf(Tag::MIN_VALUE);
+        if (dynamic_cast<const MaxValue*>(&expression)) return Leaf(Tag::MAX_VALUE);
+        if (dynamic_cast<const NullValue*>(&expression)) return Leaf(Tag::NULL_VALUE);
+        if (auto deref = dynamic_cast<const Dereference*>(&expression)) {
+            sink.Open(Tag::DEREFERENCE);
+            Write(deref->variable->Decl());
+            sink.String(deref->fieldName);
+            sink.Close();
+            return;
+        }
+        if (auto binary = dynamic_cast<const BinaryExpression*>(&expression)) {
+            sink.Open(Tag::BINARY);
+            sink.String(OPERATOR_NAMES.at(static_cast<std::size_t>(binary->op)));
+            Write(*binary->lhs);
+            Write(*binary->rhs);
+            sink.Close();
+            return;
+        }
+        throw std::logic_error("Serialization failed: unsupported expression."); // TODO: better error handling
+    }
+
+    void Write(const MemoryWrite& command) {
+        sink.Open(Tag::MEMORY_WRITE);
+        for (std::size_t index = 0; index < command.lhs.size(); ++index) {
+            Write(*command.lhs.at(index));
+            Write(*command.rhs.at(index));
+        }
+        sink.Close();
+    }
+
+    void Leaf(Tag tag) {
+        sink.Open(tag);
+        sink.Close();
+    }
+
+    template<typename T>
+    void WriteAll(const T& container) {
+        for (const auto& elem : container) elem->Accept(*this);
+    }
+
+    void Write(const MemoryAxiom& object, Tag tag) {
+        sink.Open(tag);
+        object.node->Accept(*this);
+        object.flow->Accept(*this);
+        for (const auto& [field, value] : object.fieldToValue) {
+            sink.Open(Tag::FIELD);
+            sink.String(field);
+            value->Accept(*this);
+            sink.Close();
+        }
+        sink.Close();
+    }
+
+    void Visit(const SymbolicVariable& object) override {
+        sink.Open(Tag::SYMBOL);
+        sink.String(object.Decl().name);
+        sink.String(object.Decl().type.name);
+        sink.Number(object.Decl().order == Order::FIRST ? 1 : 2);
+        sink.Close();
+    }
+    void Visit(const SymbolicBool& object) override {
+        sink.Open(Tag::BOOL);
+        sink.Number(object.value ? 1 : 0);
+        sink.Close();
+    }
+    void Visit(const SymbolicNull& /*object*/) override { Leaf(Tag::NULL_); }
+    void Visit(const SymbolicMin& /*object*/) override { Leaf(Tag::MIN); }
+    void Visit(const SymbolicMax& /*object*/) override { Leaf(Tag::MAX); }
+    void Visit(const SymbolicSelfTid& /*object*/) override { Leaf(Tag::SELF); }
+    void Visit(const SymbolicSomeTid& /*object*/) override { Leaf(Tag::SOME); }
+    void Visit(const SymbolicUnlocked& /*object*/) override { Leaf(Tag::UNLOCKED); }
+    void Visit(const SeparatingConjunction& object) override {
+        sink.Open(Tag::SEPARATING);
+        WriteAll(object.conjuncts);
+        sink.Close();
+    }
+    void Visit(const LocalMemoryResource& object) override { Write(object, Tag::LOCAL); }
+    void Visit(const SharedMemoryCore& object) override { Write(object, Tag::SHARED); }
+    void Visit(const EqualsToAxiom& object) override {
+        sink.Open(Tag::EQUALS);
+        Write(object.Variable());
+        object.value->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const StackAxiom& object) override {
+        sink.Open(Tag::STACK);
+        sink.String(OPERATOR_NAMES.at(static_cast<std::size_t>(object.op)));
+        object.lhs->Accept(*this);
+        object.rhs->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const InflowEmptinessAxiom& object) override {
+        sink.Open(Tag::INFLOW_EMPTY);
+        object.flow->Accept(*this);
+        sink.Number(object.isEmpty ? 1 : 0);
+        sink.Close();
+    }
+    void Visit(const InflowContainsValueAxiom& object) override {
+        sink.Open(Tag::INFLOW_CONTAINS);
+        object.flow->Accept(*this);
+        object.value->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const InflowContainsRangeAxiom& object) override {
+        sink.Open(Tag::INFLOW_RANGE);
+        object.flow->Accept(*this);
+        object.valueLow->Accept(*this);
+        object.valueHigh->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const ObligationAxiom& object) override {
+        sink.Open(Tag::OBLIGATION);
+        sink.String(SPECIFICATION_NAMES.at(static_cast<std::size_t>(object.spec)));
+        object.key->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const FulfillmentAxiom& object) override {
+        sink.Open(Tag::FULFILLMENT);
+        sink.Number(object.returnValue ? 1 : 0);
+        sink.Close();
+    }
+    void Visit(const NonSeparatingImplication& object) override {
+        sink.Open(Tag::IMPLICATION);
+        object.premise->Accept(*this);
+        object.conclusion->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const ImplicationSet& object) override {
+        sink.Open(Tag::IMPLICATION_SET);
+        WriteAll(object.conjuncts);
+        sink.Close();
+    }
+    void Visit(const PastPredicate& object) override {
+        sink.Open(Tag::PAST);
+        object.formula->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const Guard& object) override {
+        sink.Open(Tag::GUARD);
+        for (const auto& elem : object.conjuncts) Write(*elem);
+        sink.Close();
+    }
+    void Visit(const Update& object) override {
+        sink.Open(Tag::UPDATE);
+        for (std::size_t index = 0; index < object.fields.size(); ++index) {
+            Write(*object.fields.at(index));
+            object.values.at(index)->Accept(*this);
+        }
+        sink.Close();
+    }
+    void Visit(const FuturePredicate& object) override {
+        sink.Open(Tag::FUTURE);
+        object.update->Accept(*this);
+        object.guard->Accept(*this);
+        sink.Close();
+    }
+    void Visit(const Annotation& object) override {
+        sink.Open(Tag::ANNOTATION);
+        object.now->Accept(*this);
+        WriteAll(object.past);
+        WriteAll(object.future);
+        sink.Close();
+    }
+};
+
+LogicWriter::LogicWriter(std::ostream& stream, const Program& program, SerializationFormat format)
+        : sink(MakeSink(stream, format)) {
+    ForEachVariable(program, [this](const auto& decl, const auto& scope, const auto& id) {
+        variables.emplace(&decl, std::make_pair(scope, id));
+    });
+}
+
+LogicWriter::~LogicWriter() = default;
+
+void LogicWriter::Write(const LogicObject& object) {
+    LogicObjectWriter writer(*sink, variables);
+    object.Accept(writer);
+    sink->Finish();
+}
+
+void LogicWriter::Write(const MemoryWrite& command) {
+    LogicObjectWriter writer(*sink, variables);
+    writer.Write(command);
+    sink->Finish();
+}
+
+
+//
+// Reading
+//
+
+struct plankton::LogicObjectReader {
+    LogicReader& reader;
+    SerializationSource& source;
+
+    explicit LogicObjectReader(LogicReader& reader) : reader(reader), source(*reader.source) {}
+
+    template<typename T>
+    std::unique_ptr<T> As(std::unique_ptr<LogicObject> object) {
+        if (auto result = dynamic_cast<T*>(object.get())) {
+            object.release(); // NOLINT(bugprone-unused-return-value)
+            return std::unique_ptr<T>(result);
+        }
+        Malformed("unexpected object");
+        return nullptr;
+    }
+
+    template<typename T>
+    std::unique_ptr<T> Read() { return As<T>(ReadObject()); }
+
+    void Expect(Tag tag) {
+        if (source.Open() != tag) Malformed("unexpected tag");
+    }
+
+    const Type& ReadType() {
+        auto name = source.String();
+        auto find = reader.types.find(name);
+        if (find == reader.types.end()) Malformed("unknown type '" + name + "'");
+        return *find->second;
+    }
+
+    const VariableDeclaration& ReadVariableTail() {
+        auto scope = source.String();
+        auto id = source.String();
+        source.Close();
+        auto find = reader.variables.find({ scope, id });
+        if (find == reader.variables.end()) Malformed("unknown variable '" + id + "'");
+        return *find->second;
+    }
+
+    std::unique_ptr<SymbolicVariable> ReadSymbolTail() {
+        auto name = source.String();
+        auto& type = ReadType();
+        auto order = source.Number() == 1 ? Order::FIRST : Order::SECOND;
+        source.Close();
+        auto& decl = reader.symbols[{ name, &type, order }];
+        if (!decl) decl = &reader.factory.GetFresh(type, order);
+        return std::make_unique<SymbolicVariable>(*decl);
+    }
+
+    std::unique_ptr<SymbolicVariable> ReadSymbol() {
+        Expect(Tag::SYMBOL);
+        return ReadSymbolTail();
+    }
+
+    std::unique_ptr<VariableExpression> ReadVariableExpression() {
+        Expect(Tag::VARIABLE);
+        return std::make_unique<VariableExpression>(ReadVariableTail());
+    }
+
+    std::unique_ptr<Dereference> ReadDereference() {
+        Expect(Tag::DEREFERENCE);
+        return ReadDereferenceTail();
+    }
+
+    std::unique_ptr<Dereference> ReadDereferenceTail() {
+        auto variable = ReadVariableExpression();
+        auto field = source.String();
+        source.Close();
+        return std::make_unique<Dereference>(std::move(variable), field);
+    }
+
+    template<typename T>
+    std::unique_ptr<T> Leaf() {
+        source.Close();
+        return std::make_unique<T>();
+    }
+
+    std::unique_ptr<Expression> ReadExpression() {
+        switch (source.Open()) {
+            case Tag::VARIABLE: return std::make_unique<VariableExpression>(ReadVariableTail());
+            case Tag::TRUE_: return Leaf<TrueValue>();
+            case Tag::FALSE_: return Leaf<FalseValue>();
+            case Tag::MIN_VALUE: return Leaf<MinValue>();
+            case Tag::MAX_VALUE: return Leaf<MaxValue>();
+            case Tag::NULL_VALUE: return Leaf<NullValue>();
+            case Tag::DEREFERENCE: return ReadDereferenceTail();
+            case Tag::BINARY: {
+                auto op = OperatorFromName(source.String());
+                auto lhs = ReadValueExpression();
+                auto rhs = ReadValueExpression();
+                source.Close();
+                return std::make_unique<BinaryExpression>(op, std::move(lhs), std::move(rhs));
+            }
+            default: Malformed("expected expression");
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    std::unique_ptr<T> ReadExpressionAs() {
+        auto expression = ReadExpression();
+        if (auto result = dynamic_cast<T*>(expression.get())) {
+            expression.release(); // NOLINT(bugprone-unused-return-value)
+            return std::unique_ptr<T>(result);
+        }
+        Malformed("unexpected expression");
+        return nullptr;
+    }
+
+    std::unique_ptr<ValueExpression> ReadValueExpression() { return ReadExpressionAs<ValueExpression>(); }
+
+    std::unique_ptr<MemoryWrite> ReadMemoryWrite() {
+        Expect(Tag::MEMORY_WRITE);
+        auto result = std::make_unique<MemoryWrite>();
+        while (!source.PeekClose()) {
+            result->lhs.push_back(ReadDereference());
+            result->rhs.push_back(ReadExpressionAs<SimpleExpression>());
+        }
+        source.Close();
+        return result;
+    }
+
+    template<typename T>
+    std::unique_ptr<T> ReadMemoryTail() {
+        auto node = ReadSymbol();
+        auto flow = ReadSymbol();
+        std::map<std::string, std::unique_ptr<SymbolicVariable>> fields;
+        while (!source.PeekClose()) {
+            Expect(Tag::FIELD);
+            auto field = source.String();
+            fields[field] = ReadSymbol();
+            source.Close();
+        }
+        source.Close();
+        return std::make_unique<T>(std::move(node), std::move(flow), std::move(fields));
+    }
+
+    std::unique_ptr<SeparatingConjunction> ReadSeparatingTail() {
+        auto result = std::make_unique<SeparatingConjunction>();
+        while (!source.PeekClose()) result->Conjoin(Read<Formula>());
+        source.Close();
+        return result;
+    }
+
+    std::unique_ptr<LogicObject> ReadObject() {
+        switch (source.Open()) {
+            case Tag::SYMBOL: return ReadSymbolTail();
+            case Tag::BOOL: {
+                auto value = source.Number() != 0;
+                source.Close();
+                return std::make_unique<SymbolicBool>(value);
+            }
+            case Tag::NULL_: return Leaf<SymbolicNull>();
+            case Tag::MIN: return Leaf<SymbolicMin>();
+            case Tag::MAX: return Leaf<SymbolicMax>();
+            case Tag::SELF: return Leaf<SymbolicSelfTid>();
+            case Tag::SOME: return Leaf<SymbolicSomeTid>();
+            case Tag::UNLOCKED: return Leaf<SymbolicUnlocked>();
+            case Tag::SEPARATING: return ReadSeparatingTail();
+            case Tag::LOCAL: return ReadMemoryTail<LocalMemoryResource>();
+            case Tag::SHARED: return ReadMemoryTail<SharedMemoryCore>();
+            case Tag::EQUALS: {
+                auto variable = ReadVariableExpression();
+                auto value = ReadSymbol();
+                source.Close();
+                return std::make_unique<EqualsToAxiom>(variable->Decl(), std::move(value));
+            }
+            case Tag::STACK: {
+                auto op = OperatorFromName(source.String());
+                auto lhs = Read<SymbolicExpression>();
+                auto rhs = Read<SymbolicExpression>();
+                source.Close();
+                return std::make_unique<StackAxiom>(op, std::move(lhs), std::move(rhs));
+            }
+            case Tag::INFLOW_EMPTY: {
+                auto flow = ReadSymbol();
+                auto isEmpty = source.Number() != 0;
+                source.Close();
+                return std::make_unique<InflowEmptinessAxiom>(std::move(flow), isEmpty);
+            }
+            case Tag::INFLOW_CONTAINS: {
+                auto flow = ReadSymbol();
+                auto value = ReadSymbol();
+                source.Close();
+                return std::make_unique<InflowContainsValueAxiom>(std::move(flow), std::move(value));
+            }
+            case Tag::INFLOW_RANGE: {
+                auto flow = ReadSymbol();
+                auto low = Read<SymbolicExpression>();
+                auto high = Read<SymbolicExpression>();
+                source.Close();
+                return std::make_unique<InflowContainsRangeAxiom>(std::move(flow), std::move(low), std::move(high));
+            }
+            case Tag::OBLIGATION: {
+                auto spec = SpecificationFromName(source.String());
+                auto key = ReadSymbol();
+                source.Close();
+                return std::make_unique<ObligationAxiom>(spec, std::move(key));
+            }
+            case Tag::FULFILLMENT: {
+                auto value = source.Number() != 0;
+                source.Close();
+                return std::make_unique<FulfillmentAxiom>(value);
+            }
+            case Tag::IMPLICATION: {
+                auto premise = Read<SeparatingConjunction>();
+                auto conclusion = Read<SeparatingConjunction>();
+                source.Close();
+                return std::make_unique<NonSeparatingImplication>(std::move(premise), std::move(conclusion));
+            }
+            case Tag::IMPLICATION_SET: {
+                auto result = std::make_unique<ImplicationSet>();
+                while (!source.PeekClose()) result->Conjoin(Read<NonSeparatingImplication>());
+                source.Close();
+                return result;
+            }
+            case Tag::PAST: {
+                auto formula = Read<SharedMemoryCore>();
+                source.Close();
+                return std::make_unique<PastPredicate>(std::move(formula));
+            }
+            case Tag::GUARD: {
+                auto result = std::make_unique<Guard>();
+                while (!source.PeekClose()) result->conjuncts.push_back(ReadExpressionAs<BinaryExpression>());
+                source.Close();
+                return result;
+            }
+            case Tag::UPDATE: {
+                auto result = std::make_unique<Update>();
+                while (!source.PeekClose()) {
+                    result->fields.push_back(ReadDereference());
+                    result->values.push_back(Read<SymbolicExpression>());
+                }
+                source.Close();
+                return result;
+            }
+            case Tag::FUTURE: {
+                auto update = Read<Update>();
+                auto guard = Read<Guard>();
+                source.Close();
+                return std::make_unique<FuturePredicate>(std::move(update), std::move(guard));
+            }
+            case Tag::ANNOTATION: {
+                auto result = std::make_unique<Annotation>(Read<SeparatingConjunction>());
+                while (!source.PeekClose()) {
+                    auto object = ReadObject();
+                    if (dynamic_cast<const PastPredicate*>(object.get())) result->Conjoin(As<PastPredicate>(std::move(object)));
+                    else result->Conjoin(As<FuturePredicate>(std::move(object)));
+                }
+                source.Close();
+                return result;
+            }
+            default: Malformed("expected logic object");
+        }
+        return nullptr;
+    }
+};
+
+LogicReader::LogicReader(std::istream& stream, const Program& program, SerializationFormat format)
+        : source(MakeSource(stream, format)) {
+    for (const auto* type : { &Type::Bool(), &Type::Data(), &Type::Null(), &Type::Thread() }) types[type->name] = type;
+    for (const auto& type : program.types) types[type->name] = type.get();
+    ForEachVariable(program, [this](const auto& decl, const auto& scope, const auto& id) {
+        variables.emplace(std::make_pair(scope, id), &decl);
+    });
+}
+
+LogicReader::~LogicReader() = default;
+
+bool LogicReader::AtEnd() {
+    return source->AtEnd();
+}
+
+std::unique_ptr<LogicObject> LogicReader::Read() {
+    LogicObjectReader reader(*this);
+    return reader.ReadObject();
+}
+
+std::unique_ptr<MemoryWrite> LogicReader::ReadMemoryWrite() {
+    LogicObjectReader reader(*this);
+    return reader.ReadMemoryWrite();
+}
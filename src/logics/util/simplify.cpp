@@ -1,30 +1,14 @@
 #include "logics/util.hpp"
 
+#include <algorithm>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include "util/shortcuts.hpp"
 
 using namespace plankton;
 
 
-struct SymbolReplacementListener : public MutableLogicListener {
-    const SymbolDeclaration& search;
-    const SymbolDeclaration& replace;
-    
-    explicit SymbolReplacementListener(const SymbolDeclaration& search, const SymbolDeclaration& replace)
-            : search(search), replace(replace) {}
-    
-    void Enter(SymbolicVariable& object) override {
-        if (object.Decl() != search) return;
-        object.decl = replace;
-    }
-};
-
-inline void ApplyRenaming(LogicObject& object, const SymbolDeclaration& search, const SymbolDeclaration& replace) {
-    SymbolReplacementListener replacer(search, replace);
-    object.Accept(replacer);
-}
-
 //
 // Flatten
 //
@@ -64,38 +48,38 @@ inline void Flatten(LogicObject& object) {
 // Inline Equalities
 //
 
-struct SyntacticEqualityInliningListener final : public MutableLogicListener {
-    std::reference_wrapper<LogicObject> target;
-    explicit SyntacticEqualityInliningListener(LogicObject& target) : target(target) {}
-    
-    void Enter(StackAxiom& object) override {
-        if (object.op != BinaryOperator::EQ) return;
-        if (auto lhsVar = dynamic_cast<const SymbolicVariable*>(object.lhs.get())) {
-            if (auto rhsVar = dynamic_cast<const SymbolicVariable*>(object.rhs.get())) {
-                ApplyRenaming(target, lhsVar->Decl(), rhsVar->Decl());
-            }
-        }
+struct EqualityCollector final : public LogicListener {
+    SymbolEquivalence equivalence;
+
+    void Enter(const StackAxiom& object) override {
+        if (object.op == BinaryOperator::EQ) equivalence.Add(object);
     }
-    
+
     // do not inline across multiple contexts
-    inline void VisitWithinNewContext(LogicObject& newContext, LogicObject& toVisit) {
-        auto& oldTarget = target;
-        target = newContext;
-        toVisit.Accept(*this);
-        target = oldTarget;
-    }
-    void Visit(NonSeparatingImplication& object) override {
-        VisitWithinNewContext(object, *object.premise);
-        VisitWithinNewContext(*object.conclusion, *object.conclusion);
-    }
-    void Visit(PastPredicate& object) override {
-        VisitWithinNewContext(*object.formula, *object.formula);
-    }
+    void Visit(const NonSeparatingImplication& /*object*/) override {}
+    void Visit(const PastPredicate& /*object*/) override {}
+};
+
+inline void InlineEqualities(LogicObject& context, const LogicObject& source) {
+    // union-find over all equalities of the context, then a single renaming pass
+    EqualityCollector collector;
+    source.Accept(collector);
+    plankton::RenameSymbols(context, collector.equivalence.MakeRenaming());
+}
+
+struct ImplicationCollector final : public MutableLogicListener {
+    std::deque<NonSeparatingImplication*> result;
+    void Enter(NonSeparatingImplication& object) override { result.push_back(&object); }
 };
 
 inline void InlineEqualities(LogicObject& object) {
-    SyntacticEqualityInliningListener inlining(object);
-    object.Accept(inlining);
+    InlineEqualities(object, object);
+    ImplicationCollector collector;
+    object.Accept(collector);
+    for (auto* implication : collector.result) {
+        InlineEqualities(*implication, *implication->premise);
+        InlineEqualities(*implication->conclusion, *implication->conclusion);
+    }
 }
 
 
@@ -199,20 +183,13 @@ struct CleanUpVisitor final : public MutableDefaultLogicVisitor {
     void Visit(SeparatingConjunction& object) override {
         assert(!removeAxiom);
         
-        for (auto it = object.conjuncts.begin(); it != object.conjuncts.end(); ++it) {
-            (*it)->Accept(*this);
-            if (removeAxiom) {
-                it->reset(nullptr);
-                removeAxiom = false;
-                continue;
-            }
-            for (auto other = std::next(it); other != object.conjuncts.end(); ++other) {
-                if (!plankton::SyntacticalEqual(**it, **other)) continue;
-                it->reset(nullptr);
-                break;
-            }
+        for (auto& conjunct : object.conjuncts) {
+            conjunct->Accept(*this);
+            if (!removeAxiom) continue;
+            conjunct.reset(nullptr);
+            removeAxiom = false;
         }
-    
+        RemoveDuplicates(object.conjuncts.rbegin(), object.conjuncts.rend()); // keep last occurrence
         RemoveIf(object.conjuncts, [](const auto& elem){ return !elem; });
     }
     
@@ -221,16 +198,24 @@ struct CleanUpVisitor final : public MutableDefaultLogicVisitor {
     void Visit(PastPredicate& object) override { Walk(object); }
     void Visit(FuturePredicate& object) override { Walk(object); }
 
-    template<typename T>
-    inline void RemoveDuplicates(T& container) {
-        for (auto it = container.begin(); it != container.end(); ++it) {
+    template<typename I>
+    inline void RemoveDuplicates(I begin, I end) {
+        std::unordered_multimap<std::size_t, const LogicObject*> seen;
+        for (auto it = begin; it != end; ++it) {
             if (!*it) continue;
-            for (auto ot = std::next(it); ot != container.end(); ++ot) {
-                if (!*ot) continue;
-                if (!plankton::SyntacticalEqual(**it, **ot)) continue;
-                ot->reset(nullptr);
-            }
+            auto hash = plankton::SyntacticalHash(**it);
+            auto [first, last] = seen.equal_range(hash);
+            auto isDuplicate = std::any_of(first, last, [&it](const auto& pair) {
+                return plankton::SyntacticalEqual(*pair.second, **it);
+            });
+            if (isDuplicate) it->reset(nullptr);
+            else seen.emplace(hash, it->get());
         }
+    }
+
+    template<typename T>
+    inline void RemoveDuplicates(T& container) {
+        RemoveDuplicates(container.begin(), container.end());
         plankton::RemoveIf(container, [](const auto& elem){ return !elem; });
     }
 
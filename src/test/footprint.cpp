@@ -0,0 +1,131 @@
+#include "programs/ast.hpp"
+#include "logics/ast.hpp"
+#include "logics/util.hpp"
+#include "engine/config.hpp"
+#include "engine/solver.hpp"
+#include "engine/util.hpp"
+#include "util/log.hpp"
+
+using namespace plankton;
+
+
+//
+// Fixture
+//
+
+struct TestConfig final : public SolverConfig {
+    [[nodiscard]] const Type& GetFlowValueType() const override { return Type::Data(); }
+    [[nodiscard]] std::size_t GetMaxFootprintDepth(const Type&, const std::string&) const override { return 1; }
+    [[nodiscard]] std::unique_ptr<ImplicationSet> GetLocalNodeInvariant(const LocalMemoryResource&) const override {
+        return std::make_unique<ImplicationSet>();
+    }
+    [[nodiscard]] std::unique_ptr<ImplicationSet> GetSharedNodeInvariant(const SharedMemoryCore&) const override {
+        return std::make_unique<ImplicationSet>();
+    }
+    [[nodiscard]] std::unique_ptr<ImplicationSet> GetSharedVariableInvariant(const EqualsToAxiom&) const override {
+        return std::make_unique<ImplicationSet>();
+    }
+    [[nodiscard]] std::unique_ptr<ImplicationSet>
+    GetOutflowContains(const MemoryAxiom&, const std::string&, const SymbolDeclaration&) const override {
+        return std::make_unique<ImplicationSet>();
+    }
+    [[nodiscard]] std::unique_ptr<ImplicationSet> GetLogicallyContains(const MemoryAxiom&, const SymbolDeclaration&) const override {
+        return std::make_unique<ImplicationSet>();
+    }
+};
+
+struct Fixture {
+    Type node;
+    VariableDeclaration head;
+    Program program;
+    TestConfig config;
+
+    Fixture() : node("Node", Sort::PTR), head("Head", node, true),
+                program("Footprint", std::make_unique<Function>("init", Function::INIT, std::make_unique<Scope>(std::make_unique<Skip>()))) {
+        node.fields.emplace("next", node);
+        node.fields.emplace("val", Type::Data());
+    }
+
+    [[nodiscard]] std::unique_ptr<Annotation> MakeAnnotation() const {
+        // Head = a * a |=> Node(flow=F, next=b, val=d)
+        SymbolFactory factory;
+        auto& address = factory.GetFreshFO(node);
+        auto result = std::make_unique<Annotation>();
+        result->Conjoin(std::make_unique<EqualsToAxiom>(head, address));
+        result->Conjoin(plankton::MakeSharedMemory(address, config.GetFlowValueType(), factory));
+        return result;
+    }
+
+    [[nodiscard]] std::unique_ptr<HeapEffect> MakeEffect(const std::string& field) const {
+        // [ x |=> Node(field=v) ~~> x |=> Node(field=v') | true ]
+        SymbolFactory factory;
+        auto pre = plankton::MakeSharedMemory(factory.GetFreshFO(node), config.GetFlowValueType(), factory);
+        auto post = plankton::Copy(*pre);
+        post->fieldToValue.at(field) = std::make_unique<SymbolicVariable>(factory.GetFreshFO(node[field]));
+        return std::make_unique<HeapEffect>(std::move(pre), std::move(post), std::make_unique<SeparatingConjunction>());
+    }
+};
+
+inline void Check(bool condition, const std::string& message) {
+    if (condition) return;
+    throw std::logic_error("Check failed: " + message + "."); // TODO: better error handling
+}
+
+
+//
+// Tests
+//
+
+inline void TestEmptyInterference() {
+    // a post made stable under empty interference must be affected by the first effect on memory it contains
+    Fixture fixture;
+    Solver solver(fixture.program, fixture.config);
+    EffectFootprint footprint;
+    auto stable = solver.MakeInterferenceStable(fixture.MakeAnnotation(), &footprint);
+    Check(footprint.count({ &fixture.node, "val" }) != 0, "footprint lacks 'val' of stabilized memory");
+    Check(footprint.count({ &fixture.node, "" }) != 0, "footprint lacks flow of stabilized memory");
+
+    auto effect = fixture.MakeEffect("val");
+    Check(plankton::IsAffected(footprint, *effect), "effect on 'val' does not affect footprint");
+    std::deque<std::unique_ptr<HeapEffect>> interference;
+    interference.push_back(std::move(effect));
+    Check(solver.AddInterference(std::move(interference)), "effect on 'val' not added");
+    auto restabilized = solver.MakeInterferenceStable(fixture.MakeAnnotation());
+    Check(!plankton::SyntacticalEqual(*stable, *restabilized), "effect on 'val' does not alter stabilized post");
+}
+
+inline void TestEmptyPast() {
+    Fixture fixture;
+    Solver solver(fixture.program, fixture.config);
+    EffectFootprint footprint;
+    auto improved = solver.ImprovePast(fixture.MakeAnnotation(), &footprint);
+    Check(plankton::IsAffected(footprint, *fixture.MakeEffect("next")), "effect on 'next' does not affect footprint");
+}
+
+inline void TestNoMemory() {
+    Fixture fixture;
+    Solver solver(fixture.program, fixture.config);
+    EffectFootprint footprint;
+    auto stable = solver.MakeInterferenceStable(std::make_unique<Annotation>(), &footprint);
+    Check(footprint.empty(), "footprint of annotation without memory not empty");
+    Check(!plankton::IsAffected(footprint, *fixture.MakeEffect("val")), "effect affects empty footprint");
+}
+
+
+//
+// Main
+//
+
+int main() {
+    try {
+        TestEmptyInterference();
+        TestEmptyPast();
+        TestNoMemory();
+        INFO("All footprint tests passed." << std::endl)
+        return 0;
+
+    } catch (std::logic_error& err) { // TODO: catch proper error class
+        ERROR(err.what() << std::endl)
+        return 1;
+    }
+}
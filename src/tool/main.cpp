@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <chrono>
+#include <fstream>
 #include "tclap/CmdLine.h"
 #include "cfg2string.hpp"
+#include "engine/encoding.hpp"
 #include "engine/linearizability.hpp"
 #include "engine/setup.hpp"
 #include "parser/parse.hpp"
 #include "util/log.hpp"
+#include "util/timer.hpp"
 
 using namespace plankton;
 
@@ -17,6 +21,8 @@ struct CommandLineInput {
     std::string pathToInput;
     bool spuriousCasFail = false;
     bool printGist = false;
+    bool printStats = false;
+    std::string pathToProfile;
     EngineSetup setup;
 };
 
@@ -48,17 +54,44 @@ inline CommandLineInput Interact(int argc, char** argv) {
     TCLAP::SwitchArg macroNoTabulationSwitch("", "macroNoTabulate", "Turns off tabulation of macro post annotations", cmd, false);
     TCLAP::ValueArg<std::size_t> loopMaxIterArg("", "loopMaxIter", "Maximal iterations for finding a loop invariant before aborting", false, 23, "integer", cmd);
     TCLAP::ValueArg<std::size_t> proofMaxIterArg("", "proofMaxIter", "Maximal iterations for finding an interference set before aborting", false, 7, "integer", cmd);
+    TCLAP::SwitchArg statsSwitch("", "stats", "Measures and prints fine-grained timings of solver internals (default in debug builds)", cmd, false);
+    TCLAP::ValueArg<std::string> profileArg("", "profile-out", "Write a JSON report with per-phase timings and Z3 query counts to the given file", false, "", "path", cmd);
+    TCLAP::ValueArg<std::string> proofCacheArg("", "proof-cache", "Reuse the proof stored in the given file if the flow definition and options are unchanged (for a changed program: only its interference), update it afterwards", false, "", "path", cmd);
+    TCLAP::ValueArg<std::string> seedInterferenceArg("", "seed-interference", "Initialize the interference set with the effects from the given file, e.g., written by --store-interference", false, "", "path", cmd);
+    TCLAP::ValueArg<std::string> storeInterferenceArg("", "store-interference", "Write the final interference set to the given file", false, "", "path", cmd);
+    TCLAP::ValueArg<std::size_t> jobsArg("j", "jobs", "Number of API functions verified concurrently per fixed-point iteration", false, 1, "integer", cmd);
+    std::vector<std::string> backends;
+    for (const auto& [name, description] : plankton::GetSmtBackends()) backends.push_back(name);
+    TCLAP::ValuesConstraint<std::string> isBackend(backends);
+    TCLAP::ValueArg<std::string> backendArg("", "smt-backend", "SMT backend used for solving", false, "z3", &isBackend, cmd);
+    std::vector<std::string> batchMethods = { "consequences", "assumptions", "push-pop" };
+    TCLAP::ValuesConstraint<std::string> isBatchMethod(batchMethods);
+    TCLAP::ValueArg<std::string> batchMethodArg("", "smt-batch", "How batches of checks are solved: solver::consequences with a per-batch fallback, assumption literals, or push/pop per check", false, "consequences", &isBatchMethod, cmd);
+    TCLAP::ValueArg<std::size_t> portfolioArg("", "smt-portfolio-ms", "Race queries taking longer than the given milliseconds with a portfolio of Z3 configurations, 0 for never", false, 0, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> timeoutMsArg("", "smt-timeout-ms", "Time limit per SMT query in milliseconds, 0 for none; optional checks exceeding it count as not implied", false, 0, "integer", cmd);
+    TCLAP::ValueArg<std::size_t> rlimitArg("", "smt-rlimit", "Z3 resource limit per SMT query, 0 for none; optional checks exceeding it count as not implied", false, 0, "integer", cmd);
 
     cmd.parse(argc, argv);
     input.pathToInput = programArg.getValue();
     input.spuriousCasFail = !casSwitch.getValue();
     input.printGist = gistSwitch.getValue();
+    input.printStats = statsSwitch.getValue();
+    input.pathToProfile = profileArg.getValue();
 
     input.setup.loopJoinUntilFixpoint = !loopWidenSwitch.getValue();
     input.setup.loopJoinPost = !loopNoPostJoinSwitch.getValue();
     input.setup.macrosTabulateInvocations = !macroNoTabulationSwitch.getValue();
     input.setup.loopMaxIterations = loopMaxIterArg.getValue();
     input.setup.proofMaxIterations = proofMaxIterArg.getValue();
+    input.setup.proofJobs = std::max<std::size_t>(jobsArg.getValue(), 1);
+    input.setup.proofCachePath = proofCacheArg.getValue();
+    input.setup.interferenceSeedPath = seedInterferenceArg.getValue();
+    input.setup.interferenceOutputPath = storeInterferenceArg.getValue();
+    input.setup.smtBackend = backendArg.getValue();
+    input.setup.smtBatchMethod = batchMethodArg.getValue();
+    input.setup.smtPortfolioBudget = portfolioArg.getValue();
+    input.setup.smtTimeout = timeoutMsArg.getValue();
+    input.setup.smtResourceLimit = rlimitArg.getValue();
 
     return input;
 }
@@ -121,6 +154,14 @@ inline void PrintResult(const CommandLineInput& cmd, const ParsingResult& input,
 }
 
 
+inline void WriteProfile(const CommandLineInput& cmd) {
+    if (cmd.pathToProfile.empty()) return;
+    std::ofstream stream(cmd.pathToProfile);
+    if (!stream.good()) throw std::logic_error("Could not write profile to '" + cmd.pathToProfile + "'."); // TODO: better error handling
+    Profiler::Instance().WriteJson(stream);
+}
+
+
 //
 // Main
 //
@@ -128,10 +169,16 @@ inline void PrintResult(const CommandLineInput& cmd, const ParsingResult& input,
 int main(int argc, char** argv) {
     try {
         auto cmd = Interact(argc, argv);
+        if (cmd.printStats) Timer::SetInstrumentation(true);
+        if (!cmd.pathToProfile.empty()) {
+            Timer::SetInstrumentation(true);
+            Profiler::Instance().Enable();
+        }
         auto input = Parse(cmd);
         PrintInput(input);
         auto result = Verify(input, cmd.setup);
         PrintResult(cmd, input, result);
+        WriteProfile(cmd);
         return 0;
 
     } catch (TCLAP::ArgException& err) {